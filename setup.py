@@ -40,7 +40,29 @@ setup(
       "src/py_candle_driver.c",
       "src/py_candle_device.c",
       "src/py_candle_channel.c",
+      "src/py_candle_dbc.c",
+      "src/py_candle_frame.c",
+      "src/py_candle_subscription.c",
+      "src/py_candle_shared.c",
+      "src/py_candle_send.c",
       "src/fifo.c",
+      "src/timing.c",
+      "src/isotp.c",
+      "src/uavcan.c",
+      "src/dbc.c",
+      "src/can_error.c",
+      "src/histogram.c",
+      "src/exporter.c",
+      "src/bus_load.c",
+      "src/id_stats.c",
+      "src/notify.c",
+      "src/dispatch.c",
+      "src/broadcast.c",
+      "src/shm.c",
+      "src/bridge.c",
+      "src/gateway.c",
+      "src/recorder.c",
+      "src/txq.c",
       "src/candle_api/candle.c",
       "src/candle_api/candle_ctrl_req.c"
     ],
@@ -49,6 +71,8 @@ setup(
       "SetupApi",
       "Ole32",
       "winusb",
+      "Ws2_32",
+      "Synchronization",
     ]
   )],
 )
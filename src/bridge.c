@@ -0,0 +1,351 @@
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include "bridge.h"
+#include "broadcast.h"
+#include "timing.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Datagram: magic u16, version u8, frame count u8, sequence u32, then
+// records of can_id u32, timestamp u32, channel u8, flags u8, dlc u8 and
+// the data bytes of the dlc. All values little endian
+#define BRIDGE_MAGIC 0x4243
+#define BRIDGE_VERSION 1
+#define BRIDGE_HEADER_SIZE 8
+#define BRIDGE_RECORD_SIZE 11
+#define BRIDGE_MAX_FRAMES 255
+// Frames taken from the ring at once
+#define BRIDGE_READ_BATCH 32
+
+struct bridge_t {
+  SOCKET sock;
+  struct sockaddr_in remote;
+
+  broadcast_t* ring;
+  uint32_t batch_timeout_us;
+
+  HANDLE tx_thread;
+  HANDLE rx_thread;
+  volatile bool stop_req;
+
+  // Datagram being filled by the TX thread
+  uint8_t tx_buf[BRIDGE_MTU];
+  size_t tx_len;
+  uint8_t tx_count;
+  uint32_t tx_seq;
+
+  // Peer sequence tracking, RX thread only
+  bool rx_seq_valid;
+  uint32_t rx_expected_seq;
+
+  bridge_send_t send;
+  void* ctx;
+
+  bridge_stats_t stats;
+};
+
+static void bridge_put_u16(uint8_t* p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void bridge_put_u32(uint8_t* p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t bridge_get_u16(const uint8_t* p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t bridge_get_u32(const uint8_t* p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void bridge_flush(bridge_t* bridge)
+{
+  if (!bridge->tx_count)
+    return;
+
+  uint8_t* header = bridge->tx_buf;
+  bridge_put_u16(header, BRIDGE_MAGIC);
+  header[2] = BRIDGE_VERSION;
+  header[3] = bridge->tx_count;
+  bridge_put_u32(header + 4, bridge->tx_seq++);
+
+  // Socket is connected to the remote peer
+  int res = send(bridge->sock, (const char*)bridge->tx_buf, (int)bridge->tx_len, 0);
+
+  if (res == (int)bridge->tx_len) {
+    bridge->stats.tx_datagrams++;
+    bridge->stats.tx_frames += bridge->tx_count;
+  } else {
+    bridge->stats.tx_errors++;
+  }
+
+  bridge->tx_len = BRIDGE_HEADER_SIZE;
+  bridge->tx_count = 0;
+}
+
+// Appends frame to the datagram, returns true if it started a new batch
+static bool bridge_encode(bridge_t* bridge, candle_frame_t* frame)
+{
+  uint8_t size = candle_frame_size(frame);
+
+  if (bridge->tx_len + BRIDGE_RECORD_SIZE + size > BRIDGE_MTU || bridge->tx_count == BRIDGE_MAX_FRAMES)
+    bridge_flush(bridge);
+
+  uint8_t* p = bridge->tx_buf + bridge->tx_len;
+  bridge_put_u32(p, frame->can_id);
+  bridge_put_u32(p + 4, frame->timestamp_us);
+  p[8] = frame->channel;
+  p[9] = frame->flags;
+  p[10] = frame->can_dlc;
+  memcpy(p + BRIDGE_RECORD_SIZE, frame->data, size);
+
+  bridge->tx_len += BRIDGE_RECORD_SIZE + size;
+
+  return bridge->tx_count++ == 0;
+}
+
+static DWORD WINAPI bridge_tx_thread(LPVOID lpParam)
+{
+  bridge_t* bridge = (bridge_t*)lpParam;
+  candle_frame_t frames[BRIDGE_READ_BATCH];
+  int64_t cursor = broadcast_tail(bridge->ring);
+  uint64_t dropped = 0;
+  uint64_t deadline_us = 0;
+
+  while (!bridge->stop_req) {
+    uint32_t wait_ms = BRIDGE_POLL_INTERVAL;
+
+    // Pending batch limits the wait, ms granularity rounds the timeout up
+    if (bridge->tx_count) {
+      uint64_t now = timing_now_us();
+      if (now >= deadline_us) {
+        bridge_flush(bridge);
+        continue;
+      }
+      wait_ms = (uint32_t)((deadline_us - now + 999) / 1000);
+    }
+
+    size_t count = broadcast_read(bridge->ring, &cursor, frames, BRIDGE_READ_BATCH, wait_ms, &dropped);
+    bridge->stats.tx_overruns = dropped;
+
+    for (size_t i = 0; i < count; ++i) {
+      if (bridge_encode(bridge, &frames[i]))
+        deadline_us = timing_now_us() + bridge->batch_timeout_us;
+    }
+
+    if (!bridge->batch_timeout_us)
+      bridge_flush(bridge);
+  }
+
+  bridge_flush(bridge);
+
+  return 0;
+}
+
+static void bridge_apply(bridge_t* bridge, const uint8_t* buf, size_t len)
+{
+  if (len < BRIDGE_HEADER_SIZE || bridge_get_u16(buf) != BRIDGE_MAGIC || buf[2] != BRIDGE_VERSION) {
+    bridge->stats.rx_invalid++;
+    return;
+  }
+
+  uint8_t count = buf[3];
+  uint32_t seq = bridge_get_u32(buf + 4);
+
+  int32_t gap = (int32_t)(seq - bridge->rx_expected_seq);
+
+  if (!bridge->rx_seq_valid || gap > BRIDGE_SEQ_RESYNC || gap < -BRIDGE_SEQ_RESYNC) {
+    if (bridge->rx_seq_valid)
+      bridge->stats.rx_resyncs++;
+    bridge->rx_expected_seq = seq + 1;
+    bridge->rx_seq_valid = true;
+  } else if (gap >= 0) {
+    bridge->stats.rx_lost += gap;
+    bridge->rx_expected_seq = seq + 1;
+  } else {
+    // Late or duplicated datagram, its frames are still applied
+    bridge->stats.rx_out_of_order++;
+  }
+  bridge->stats.rx_datagrams++;
+
+  const uint8_t* p = buf + BRIDGE_HEADER_SIZE;
+  const uint8_t* end = buf + len;
+
+  for (uint8_t i = 0; i < count; ++i) {
+    candle_frame_t frame;
+
+    if (end - p < BRIDGE_RECORD_SIZE) {
+      bridge->stats.rx_invalid++;
+      return;
+    }
+
+    memset(&frame, 0, sizeof(frame));
+    frame.can_id = bridge_get_u32(p);
+    frame.timestamp_us = bridge_get_u32(p + 4);
+    frame.channel = p[8];
+    frame.flags = p[9];
+    frame.can_dlc = p[10];
+
+    uint8_t size = candle_frame_size(&frame);
+    if (end - p < BRIDGE_RECORD_SIZE + size || size > sizeof(frame.data)) {
+      bridge->stats.rx_invalid++;
+      return;
+    }
+
+    memcpy(frame.data, p + BRIDGE_RECORD_SIZE, size);
+    p += BRIDGE_RECORD_SIZE + size;
+
+    bridge->stats.rx_frames++;
+    if (!bridge->send(bridge->ctx, &frame))
+      bridge->stats.can_tx_errors++;
+  }
+}
+
+static DWORD WINAPI bridge_rx_thread(LPVOID lpParam)
+{
+  bridge_t* bridge = (bridge_t*)lpParam;
+  uint8_t buf[BRIDGE_MTU];
+
+  while (!bridge->stop_req) {
+    fd_set readfds;
+    struct timeval tv = {0, BRIDGE_POLL_INTERVAL * 1000};
+
+    FD_ZERO(&readfds);
+    FD_SET(bridge->sock, &readfds);
+
+    // Wake periodically to check stop request
+    if (select(0, &readfds, NULL, NULL, &tv) <= 0)
+      continue;
+
+    // Drain every queued datagram per wakeup (windows has no recvmmsg)
+    for (;;) {
+      struct sockaddr_in from;
+      int from_len = sizeof(from);
+
+      int n = recvfrom(bridge->sock, (char*)buf, sizeof(buf), 0, (struct sockaddr*)&from, &from_len);
+      if (n <= 0)
+        break;
+
+      // Connected socket filters other senders, datagrams queued before
+      // connect() are checked here. Anything else could inject frames
+      if (from_len != sizeof(from) || from.sin_family != AF_INET ||
+          from.sin_addr.s_addr != bridge->remote.sin_addr.s_addr || from.sin_port != bridge->remote.sin_port) {
+        bridge->stats.rx_rejected++;
+        continue;
+      }
+
+      bridge_apply(bridge, buf, n);
+    }
+  }
+
+  return 0;
+}
+
+static bool bridge_address(struct sockaddr_in* addr, const char* address, uint16_t port)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->sin_family = AF_INET;
+  addr->sin_port = htons(port);
+
+  return inet_pton(AF_INET, address, &addr->sin_addr) == 1;
+}
+
+bridge_t* bridge_create(const char* local_address, uint16_t local_port, const char* remote_address, uint16_t remote_port,
+  uint32_t batch_timeout_us, bridge_send_t send, void* ctx)
+{
+  WSADATA wsa;
+  struct sockaddr_in local;
+  u_long non_blocking = 1;
+
+  if (WSAStartup(MAKEWORD(2, 2), &wsa))
+    return NULL;
+
+  bridge_t* bridge = calloc(1, sizeof(bridge_t));
+  if (!bridge) {
+    WSACleanup();
+    return NULL;
+  }
+
+  bridge->sock = INVALID_SOCKET;
+  bridge->batch_timeout_us = batch_timeout_us;
+  bridge->tx_len = BRIDGE_HEADER_SIZE;
+  bridge->send = send;
+  bridge->ctx = ctx;
+
+  if (!bridge_address(&local, local_address, local_port) ||
+      !bridge_address(&bridge->remote, remote_address, remote_port)) {
+    bridge_delete(bridge);
+    return NULL;
+  }
+
+  bridge->ring = broadcast_create(sizeof(candle_frame_t), BRIDGE_RING_SIZE);
+  bridge->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+  if (!bridge->ring || bridge->sock == INVALID_SOCKET ||
+      bind(bridge->sock, (struct sockaddr*)&local, sizeof(local)) ||
+      connect(bridge->sock, (struct sockaddr*)&bridge->remote, sizeof(bridge->remote))) {
+    bridge_delete(bridge);
+    return NULL;
+  }
+
+  // RX thread drains until the socket would block
+  ioctlsocket(bridge->sock, FIONBIO, &non_blocking);
+
+  DWORD id;
+  bridge->tx_thread = CreateThread(NULL, 0, bridge_tx_thread, (PVOID)bridge, 0, &id);
+  bridge->rx_thread = CreateThread(NULL, 0, bridge_rx_thread, (PVOID)bridge, 0, &id);
+
+  if (!bridge->tx_thread || !bridge->rx_thread) {
+    bridge_delete(bridge);
+    return NULL;
+  }
+
+  return bridge;
+}
+
+void bridge_delete(bridge_t* bridge)
+{
+  if (!bridge)
+    return;
+
+  bridge->stop_req = true;
+
+  if (bridge->tx_thread) {
+    WaitForSingleObject(bridge->tx_thread, INFINITE);
+    CloseHandle(bridge->tx_thread);
+  }
+
+  if (bridge->rx_thread) {
+    WaitForSingleObject(bridge->rx_thread, INFINITE);
+    CloseHandle(bridge->rx_thread);
+  }
+
+  if (bridge->sock != INVALID_SOCKET)
+    closesocket(bridge->sock);
+
+  broadcast_delete(bridge->ring);
+  free(bridge);
+
+  WSACleanup();
+}
+
+void bridge_push(bridge_t* bridge, const candle_frame_t* frame)
+{
+  broadcast_write(bridge->ring, frame);
+}
+
+const bridge_stats_t* bridge_stats(bridge_t* bridge)
+{
+  return &bridge->stats;
+}
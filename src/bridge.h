@@ -0,0 +1,56 @@
+#ifndef _BRIDGE_H_
+#define _BRIDGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "candle_api/candle.h"
+
+#define BRIDGE_DEFAULT_PORT 20000
+// Datagram size limit, stays below common MTUs
+#define BRIDGE_MTU 1400
+// Frames waiting to be batched, RX thread never blocks on the bridge
+#define BRIDGE_RING_SIZE 4096
+#define BRIDGE_POLL_INTERVAL 100 // in ms
+// Sequence jumps larger than this are taken as a restarted peer
+#define BRIDGE_SEQ_RESYNC 1024
+
+// Applies frame received from the peer, called on the bridge RX thread
+typedef bool (*bridge_send_t)(void* ctx, const void* frame);
+
+typedef struct bridge_stats_t {
+  volatile int64_t tx_datagrams;
+  volatile int64_t tx_frames;
+  volatile int64_t tx_errors;
+  // Frames overwritten in the ring before they were batched
+  volatile int64_t tx_overruns;
+  volatile int64_t rx_datagrams;
+  volatile int64_t rx_frames;
+  // Datagrams missing from the peer sequence
+  volatile int64_t rx_lost;
+  volatile int64_t rx_out_of_order;
+  volatile int64_t rx_invalid;
+  volatile int64_t rx_resyncs;
+  // Datagrams from senders other than the remote peer
+  volatile int64_t rx_rejected;
+  // Received frames candle_frame_send failed for
+  volatile int64_t can_tx_errors;
+} bridge_stats_t;
+
+// CAN over UDP bridge. Frames pushed by the RX thread are batched into
+// datagrams with a sequence number, sent when full or batch_timeout_us
+// after their first frame. Datagrams from the peer are applied through send.
+// Opaque so winsock2.h does not leak into modules that include windows.h first
+typedef struct bridge_t bridge_t;
+
+// Returns NULL when addresses are invalid or local port can not be bound
+bridge_t* bridge_create(const char* local_address, uint16_t local_port, const char* remote_address, uint16_t remote_port,
+  uint32_t batch_timeout_us, bridge_send_t send, void* ctx);
+void bridge_delete(bridge_t* bridge);
+
+// Queues frame for the peer, called by the single RX thread
+void bridge_push(bridge_t* bridge, const candle_frame_t* frame);
+
+const bridge_stats_t* bridge_stats(bridge_t* bridge);
+
+#endif
@@ -0,0 +1,149 @@
+#include "broadcast.h"
+#include <stdlib.h>
+#include <string.h>
+
+broadcast_t* broadcast_create(size_t element_size, size_t element_count)
+{
+  size_t size = 16;
+  while (size < element_count)
+    size <<= 1;
+
+  broadcast_t* broadcast = malloc(sizeof(broadcast_t));
+  if (!broadcast)
+    return NULL;
+
+  broadcast->buf = malloc(element_size*size);
+  if (!broadcast->buf) {
+    free(broadcast);
+    return NULL;
+  }
+
+  broadcast->element_size = element_size;
+  broadcast->element_count = size;
+  broadcast->mask = size - 1;
+  broadcast->write_seq = 0;
+  broadcast->waiters = 0;
+
+  InitializeConditionVariable(&broadcast->not_empty);
+  InitializeSRWLock(&broadcast->lock);
+
+  return broadcast;
+}
+
+void broadcast_delete(broadcast_t* broadcast)
+{
+  if (!broadcast)
+    return;
+
+  WakeAllConditionVariable(&broadcast->not_empty);
+
+  free(broadcast->buf);
+  free(broadcast);
+}
+
+static void* broadcast_slot(void* buf, size_t element_size, size_t mask, int64_t seq)
+{
+  return (uint8_t*)buf + ((size_t)seq & mask)*element_size;
+}
+
+void broadcast_store(void* buf, size_t element_size, size_t mask, volatile int64_t* write_seq, const void* item)
+{
+  memcpy(broadcast_slot(buf, element_size, mask, *write_seq), item, element_size);
+
+  // Interlocked increment orders the copy before publication and the
+  // waiters check after it (readers do the same in reverse)
+  InterlockedIncrement64(write_seq);
+}
+
+void broadcast_write(broadcast_t* broadcast, const void* item)
+{
+  broadcast_store(broadcast->buf, broadcast->element_size, broadcast->mask, &broadcast->write_seq, item);
+
+  if (broadcast->waiters) {
+    AcquireSRWLockExclusive(&broadcast->lock);
+    WakeAllConditionVariable(&broadcast->not_empty);
+    ReleaseSRWLockExclusive(&broadcast->lock);
+  }
+}
+
+static bool broadcast_wait(broadcast_t* broadcast, int64_t cursor, uint32_t timeout)
+{
+  if (broadcast->write_seq != cursor)
+    return true;
+
+  if (!timeout)
+    return false;
+
+  ULONGLONG deadline = GetTickCount64() + timeout;
+
+  InterlockedIncrement(&broadcast->waiters);
+  AcquireSRWLockExclusive(&broadcast->lock);
+
+  while (broadcast->write_seq == cursor) {
+    uint32_t wait_ms = INFINITE;
+
+    if (timeout != INFINITE) {
+      ULONGLONG now = GetTickCount64();
+      if (now >= deadline)
+        break;
+      wait_ms = (uint32_t)(deadline - now);
+    }
+
+    SleepConditionVariableSRW(&broadcast->not_empty, &broadcast->lock, wait_ms, 0);
+  }
+
+  ReleaseSRWLockExclusive(&broadcast->lock);
+  InterlockedDecrement(&broadcast->waiters);
+
+  return broadcast->write_seq != cursor;
+}
+
+size_t broadcast_copy(void* buf, size_t element_size, size_t mask, const volatile int64_t* write_seq, int64_t* cursor, void* items, size_t max_count, uint64_t* dropped)
+{
+  int64_t size = (int64_t)mask + 1;
+  int64_t seq = *write_seq;
+  MemoryBarrier();
+
+  // Slot of write_seq - size is the one the writer may be filling right now
+  int64_t oldest = seq - size + 1;
+  if (*cursor < oldest) {
+    *dropped += oldest - *cursor;
+    *cursor = oldest;
+  }
+
+  size_t count = (size_t)(seq - *cursor);
+  if (count > max_count)
+    count = max_count;
+
+  for (size_t i = 0; i < count; ++i)
+    memcpy((uint8_t*)items + i*element_size, broadcast_slot(buf, element_size, mask, *cursor + i), element_size);
+
+  // Items overwritten while being copied may be torn and are dropped
+  MemoryBarrier();
+  oldest = *write_seq - size + 1;
+
+  size_t torn = 0;
+  if (*cursor < oldest)
+    torn = (size_t)(oldest - *cursor) < count ? (size_t)(oldest - *cursor) : count;
+
+  if (torn) {
+    memmove(items, (uint8_t*)items + torn*element_size, (count - torn)*element_size);
+    *dropped += torn;
+  }
+
+  *cursor += count;
+
+  // Whole batch was overwritten, newer items are available right away
+  if (count && torn == count)
+    return broadcast_copy(buf, element_size, mask, write_seq, cursor, items, max_count, dropped);
+
+  return count - torn;
+}
+
+size_t broadcast_read(broadcast_t* broadcast, int64_t* cursor, void* items, size_t max_count, uint32_t timeout, uint64_t* dropped)
+{
+  if (!max_count || !broadcast_wait(broadcast, *cursor, timeout))
+    return 0;
+
+  return broadcast_copy(broadcast->buf, broadcast->element_size, broadcast->mask, &broadcast->write_seq, cursor, items, max_count, dropped);
+}
@@ -0,0 +1,49 @@
+#ifndef _BROADCAST_H_
+#define _BROADCAST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <windows.h>
+#include <synchapi.h>
+
+// Single writer ring read by any number of readers, each with its own
+// cursor. Writer never waits for readers: a reader that falls more than the
+// ring size behind skips the overwritten items and counts them as dropped
+typedef struct broadcast_t {
+  size_t element_size;
+  size_t element_count;
+  size_t mask;
+  void* buf;
+
+  // Number of items ever written, slot of item n is n & mask
+  volatile int64_t write_seq;
+
+  // Blocking readers, writer only takes the lock when someone waits
+  volatile LONG waiters;
+  CONDITION_VARIABLE not_empty;
+  SRWLOCK lock;
+} broadcast_t;
+
+// Element count is rounded up to a power of two
+broadcast_t* broadcast_create(size_t element_size, size_t element_count);
+void broadcast_delete(broadcast_t* broadcast);
+
+// Called by the single writer thread
+void broadcast_write(broadcast_t* broadcast, const void* item);
+
+// Copies up to max_count items from cursor on, waiting up to timeout ms for
+// the first one. Advances cursor and adds skipped items to dropped
+size_t broadcast_read(broadcast_t* broadcast, int64_t* cursor, void* items, size_t max_count, uint32_t timeout, uint64_t* dropped);
+
+// Lock-free ring operations on raw parts, also used on shared memory rings.
+// Size is mask + 1 items
+void broadcast_store(void* buf, size_t element_size, size_t mask, volatile int64_t* write_seq, const void* item);
+size_t broadcast_copy(void* buf, size_t element_size, size_t mask, const volatile int64_t* write_seq, int64_t* cursor, void* items, size_t max_count, uint64_t* dropped);
+
+static inline int64_t broadcast_tail(broadcast_t* broadcast)
+{
+  return broadcast->write_seq;
+}
+
+#endif
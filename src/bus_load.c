@@ -0,0 +1,160 @@
+#include "bus_load.h"
+
+#define CRC15_POLY 0x4599
+
+// CRC delimiter, ACK slot, ACK delimiter, end of frame and interframe space
+#define FRAME_TRAILER_BITS (1 + 1 + 1 + 7 + 3)
+
+// CAN FD CRC field: stuff count, CRC and fixed stuff bits every 4 bits
+#define FD_CRC17_FIELD_BITS (4 + 17 + 6)
+#define FD_CRC21_FIELD_BITS (4 + 21 + 7)
+
+// Bit stream from SOF up to the end of stuffed region
+typedef struct bit_stream_t {
+  uint32_t bits[2];
+  // Bits are counted to data phase after BRS
+  uint8_t phase;
+  uint8_t last;
+  uint8_t run;
+  uint16_t crc;
+} bit_stream_t;
+
+static void bit_stream_push(bit_stream_t* s, uint8_t bit)
+{
+  uint8_t crc_next = bit ^ ((s->crc >> 14) & 1);
+  s->crc = (s->crc << 1) & 0x7FFF;
+  if (crc_next)
+    s->crc ^= CRC15_POLY;
+
+  s->bits[s->phase]++;
+
+  // Five equal bits are followed by a complementary stuff bit
+  if (bit == s->last) {
+    if (++s->run == 5) {
+      s->bits[s->phase]++;
+      s->last = !bit;
+      s->run = 1;
+    }
+  } else {
+    s->last = bit;
+    s->run = 1;
+  }
+}
+
+// Pushes count bits of value, MSB first
+static void bit_stream_push_value(bit_stream_t* s, uint32_t value, uint8_t count)
+{
+  while (count--)
+    bit_stream_push(s, (value >> count) & 1);
+}
+
+void bus_load_frame_bits(const candle_frame_t* frame, uint32_t* nominal_bits, uint32_t* data_bits)
+{
+  candle_frame_t* f = (candle_frame_t*)frame;
+  bit_stream_t s = {{0, 0}, 0, 2, 0, 0};
+  uint32_t id = candle_frame_id(f);
+  bool extended = candle_frame_is_extended_id(f);
+  bool fd = candle_frame_is_fd(f);
+  bool rtr = !fd && candle_frame_is_rtr(f);
+  uint8_t size = rtr ? 0 : candle_frame_size(f);
+
+  // SOF
+  bit_stream_push(&s, 0);
+
+  if (extended) {
+    bit_stream_push_value(&s, id >> 18, 11);
+    // SRR and IDE
+    bit_stream_push(&s, 1);
+    bit_stream_push(&s, 1);
+    bit_stream_push_value(&s, id & 0x3FFFF, 18);
+  } else {
+    bit_stream_push_value(&s, id, 11);
+  }
+
+  if (fd) {
+    // RRS, IDE (base format only), FDF, res, BRS
+    bit_stream_push(&s, 0);
+    if (!extended)
+      bit_stream_push(&s, 0);
+    bit_stream_push(&s, 1);
+    bit_stream_push(&s, 0);
+    bit_stream_push(&s, (frame->flags & CANDLE_FLAG_BRS) ? 1 : 0);
+
+    if (frame->flags & CANDLE_FLAG_BRS)
+      s.phase = 1;
+
+    bit_stream_push(&s, (frame->flags & CANDLE_FLAG_ESI) ? 1 : 0);
+  } else {
+    // RTR, IDE (base format only) or r1, r0
+    bit_stream_push(&s, rtr);
+    bit_stream_push(&s, 0);
+    bit_stream_push(&s, 0);
+  }
+
+  bit_stream_push_value(&s, frame->can_dlc & 0x0F, 4);
+
+  for (uint8_t i = 0; i < size; ++i)
+    bit_stream_push_value(&s, frame->data[i], 8);
+
+  if (fd) {
+    // CAN FD CRC field uses fixed stuffing so its length is known
+    s.bits[s.phase] += size > 16 ? FD_CRC21_FIELD_BITS : FD_CRC17_FIELD_BITS;
+  } else {
+    // CRC is part of the stuffed region
+    uint16_t crc = s.crc;
+    bit_stream_push_value(&s, crc, 15);
+  }
+
+  *nominal_bits = s.bits[0] + FRAME_TRAILER_BITS;
+  *data_bits = s.bits[1];
+}
+
+void bus_load_add(bus_load_t* load, uint64_t time_us, const candle_frame_t* frame)
+{
+  uint32_t ms = (uint32_t)(time_us / 1000);
+  bus_load_bucket_t* bucket = &load->buckets[ms % BUS_LOAD_BUCKET_COUNT];
+  uint32_t nominal_bits, data_bits;
+
+  bus_load_frame_bits(frame, &nominal_bits, &data_bits);
+
+  // Bucket still holds a millisecond from the previous round
+  if (bucket->ms != ms) {
+    bucket->nominal_bits = 0;
+    bucket->data_bits = 0;
+    bucket->ms = ms;
+  }
+
+  bucket->nominal_bits += nominal_bits;
+  bucket->data_bits += data_bits;
+}
+
+double bus_load_get(const bus_load_t* load, uint64_t now_us, uint32_t window_ms, uint32_t bitrate, uint32_t data_bitrate)
+{
+  uint64_t nominal_bits = 0;
+  uint64_t data_bits = 0;
+  uint32_t end_ms = (uint32_t)(now_us / 1000) - BUS_LOAD_DELAY_MS;
+
+  if (!bitrate || !window_ms)
+    return 0;
+
+  if (window_ms > BUS_LOAD_MAX_WINDOW_MS)
+    window_ms = BUS_LOAD_MAX_WINDOW_MS;
+
+  // Bitrate switch without known data bitrate is accounted at nominal bitrate
+  if (!data_bitrate)
+    data_bitrate = bitrate;
+
+  for (uint32_t i = 0; i < window_ms; ++i) {
+    uint32_t ms = end_ms - i;
+    const bus_load_bucket_t* bucket = &load->buckets[ms % BUS_LOAD_BUCKET_COUNT];
+
+    if (bucket->ms == ms) {
+      nominal_bits += bucket->nominal_bits;
+      data_bits += bucket->data_bits;
+    }
+  }
+
+  double busy_s = (double)nominal_bits / bitrate + (double)data_bits / data_bitrate;
+
+  return busy_s / (window_ms / 1000.0);
+}
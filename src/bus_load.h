@@ -0,0 +1,39 @@
+#ifndef _BUS_LOAD_H_
+#define _BUS_LOAD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "candle_api/candle.h"
+
+// Load is accumulated in 1ms buckets, so any window up to
+// BUS_LOAD_BUCKET_COUNT ms can be evaluated
+#define BUS_LOAD_BUCKET_COUNT 1024
+#define BUS_LOAD_MAX_WINDOW_MS 1000
+// Newest buckets are skipped when evaluating load because frames arrive
+// over USB with a delay and those buckets are not complete yet
+#define BUS_LOAD_DELAY_MS 2
+
+typedef struct bus_load_bucket_t {
+  uint32_t ms;
+  // Bits at nominal and at data (CAN FD BRS) bitrate
+  uint32_t nominal_bits;
+  uint32_t data_bits;
+} bus_load_bucket_t;
+
+// Written by the RX thread only
+typedef struct bus_load_t {
+  bus_load_bucket_t buckets[BUS_LOAD_BUCKET_COUNT];
+} bus_load_t;
+
+// On-wire length of the frame from SOF to the end of interframe space,
+// including stuff bits. Bits after the BRS bit of CAN FD frames with bitrate
+// switch are counted as data bits
+void bus_load_frame_bits(const candle_frame_t* frame, uint32_t* nominal_bits, uint32_t* data_bits);
+
+// Accounts frame that finished at host time time_us
+void bus_load_add(bus_load_t* load, uint64_t time_us, const candle_frame_t* frame);
+
+// Returns fraction of the window (ending at host time now_us) the bus was busy
+double bus_load_get(const bus_load_t* load, uint64_t now_us, uint32_t window_ms, uint32_t bitrate, uint32_t data_bitrate);
+
+#endif
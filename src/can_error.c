@@ -0,0 +1,114 @@
+#include "can_error.h"
+
+// Error class (can_id)
+#define CAN_ERR_TX_TIMEOUT 0x0001
+#define CAN_ERR_LOSTARB    0x0002
+#define CAN_ERR_CRTL       0x0004
+#define CAN_ERR_PROT       0x0008
+#define CAN_ERR_TRX        0x0010
+#define CAN_ERR_ACK        0x0020
+#define CAN_ERR_BUSOFF     0x0040
+#define CAN_ERR_RESTARTED  0x0100
+#define CAN_ERR_CNT        0x0200
+
+// Controller status (data[1])
+#define CAN_ERR_CRTL_RX_OVERFLOW 0x01
+#define CAN_ERR_CRTL_TX_OVERFLOW 0x02
+#define CAN_ERR_CRTL_RX_WARNING  0x04
+#define CAN_ERR_CRTL_TX_WARNING  0x08
+#define CAN_ERR_CRTL_RX_PASSIVE  0x10
+#define CAN_ERR_CRTL_TX_PASSIVE  0x20
+#define CAN_ERR_CRTL_ACTIVE      0x40
+
+// Protocol violation type (data[2])
+#define CAN_ERR_PROT_BIT   0x01
+#define CAN_ERR_PROT_FORM  0x02
+#define CAN_ERR_PROT_STUFF 0x04
+#define CAN_ERR_PROT_BIT0  0x08
+#define CAN_ERR_PROT_BIT1  0x10
+
+// Protocol violation location (data[3])
+#define CAN_ERR_PROT_LOC_CRC_SEQ 0x08
+#define CAN_ERR_PROT_LOC_CRC_DEL 0x18
+
+static void can_error_set_state(can_error_stats_t* stats, can_state_t state)
+{
+  if (stats->state == state)
+    return;
+
+  switch (state) {
+    case CAN_STATE_ERROR_WARNING:
+      stats->counters.warning_count++;
+      break;
+    case CAN_STATE_ERROR_PASSIVE:
+      stats->counters.passive_count++;
+      break;
+    case CAN_STATE_BUS_OFF:
+      stats->counters.bus_off_count++;
+      break;
+    default:
+      break;
+  }
+
+  stats->state = state;
+}
+
+void can_error_decode(can_error_stats_t* stats, candle_frame_t* frame)
+{
+  uint32_t err = frame->can_id;
+  uint8_t* data = frame->data;
+
+  stats->counters.error_frames++;
+  stats->last_timestamp_us = frame->timestamp_us;
+
+  if (err & CAN_ERR_TX_TIMEOUT)
+    stats->counters.tx_timeouts++;
+
+  if (err & CAN_ERR_LOSTARB)
+    stats->counters.arbitration_lost++;
+
+  if (err & CAN_ERR_CRTL) {
+    if (data[1] & CAN_ERR_CRTL_RX_OVERFLOW)
+      stats->counters.rx_overflows++;
+    if (data[1] & CAN_ERR_CRTL_TX_OVERFLOW)
+      stats->counters.tx_overflows++;
+  }
+
+  if (err & CAN_ERR_PROT) {
+    if (data[2] & (CAN_ERR_PROT_BIT | CAN_ERR_PROT_BIT0 | CAN_ERR_PROT_BIT1))
+      stats->counters.bit_errors++;
+    if (data[2] & CAN_ERR_PROT_FORM)
+      stats->counters.form_errors++;
+    if (data[2] & CAN_ERR_PROT_STUFF)
+      stats->counters.stuff_errors++;
+    if (data[3] == CAN_ERR_PROT_LOC_CRC_SEQ || data[3] == CAN_ERR_PROT_LOC_CRC_DEL)
+      stats->counters.crc_errors++;
+  }
+
+  if (err & CAN_ERR_TRX)
+    stats->counters.transceiver_errors++;
+
+  if (err & CAN_ERR_ACK)
+    stats->counters.ack_errors++;
+
+  // Error counters are valid when flagged (newer firmware) or with controller state
+  if (err & (CAN_ERR_CNT | CAN_ERR_CRTL | CAN_ERR_BUSOFF)) {
+    stats->tx_errors = data[6];
+    stats->rx_errors = data[7];
+  }
+
+  // Most severe state wins
+  if (err & CAN_ERR_BUSOFF) {
+    can_error_set_state(stats, CAN_STATE_BUS_OFF);
+  } else if (err & CAN_ERR_RESTARTED) {
+    stats->counters.restart_count++;
+    can_error_set_state(stats, CAN_STATE_ERROR_ACTIVE);
+  } else if (err & CAN_ERR_CRTL) {
+    if (data[1] & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE))
+      can_error_set_state(stats, CAN_STATE_ERROR_PASSIVE);
+    else if (data[1] & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING))
+      can_error_set_state(stats, CAN_STATE_ERROR_WARNING);
+    else if (data[1] & CAN_ERR_CRTL_ACTIVE)
+      can_error_set_state(stats, CAN_STATE_ERROR_ACTIVE);
+  }
+}
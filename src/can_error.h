@@ -0,0 +1,51 @@
+#ifndef _CAN_ERROR_H_
+#define _CAN_ERROR_H_
+
+#include <stdint.h>
+#include "candle_api/candle.h"
+
+typedef enum {
+  CAN_STATE_ERROR_ACTIVE,
+  CAN_STATE_ERROR_WARNING,
+  CAN_STATE_ERROR_PASSIVE,
+  CAN_STATE_BUS_OFF,
+} can_state_t;
+
+// Error frame counters, all int64 so they can be reset with a baseline
+// snapshot like candle_channel_stats_t
+typedef struct can_error_counters_t {
+  volatile int64_t error_frames;
+
+  // State transitions
+  volatile int64_t warning_count;
+  volatile int64_t passive_count;
+  volatile int64_t bus_off_count;
+  volatile int64_t restart_count;
+
+  volatile int64_t arbitration_lost;
+  volatile int64_t bit_errors;
+  volatile int64_t stuff_errors;
+  volatile int64_t form_errors;
+  volatile int64_t ack_errors;
+  volatile int64_t crc_errors;
+  volatile int64_t tx_timeouts;
+  volatile int64_t transceiver_errors;
+  volatile int64_t rx_overflows;
+  volatile int64_t tx_overflows;
+} can_error_counters_t;
+
+// Decoded error frames, written only by the RX thread
+typedef struct can_error_stats_t {
+  // Current controller state
+  uint8_t state;
+  uint8_t tx_errors;
+  uint8_t rx_errors;
+  uint32_t last_timestamp_us;
+
+  can_error_counters_t counters;
+} can_error_stats_t;
+
+// Decodes SocketCAN style error frame sent by gs_usb firmware
+void can_error_decode(can_error_stats_t* stats, candle_frame_t* frame);
+
+#endif
@@ -466,6 +466,56 @@ bool __stdcall DLL candle_channel_set_bitrate(candle_handle hdev, uint8_t ch, ui
     return candle_ctrl_set_bittiming(dev, ch, &t);
 }
 
+bool __stdcall DLL candle_channel_set_data_timing(candle_handle hdev, uint8_t ch, candle_bittiming_t *data)
+{
+    // TODO ensure device is open, check channel count..
+    candle_device_t *dev = (candle_device_t*)hdev;
+    return candle_ctrl_set_data_bittiming(dev, ch, data);
+}
+
+bool __stdcall DLL candle_channel_set_data_bitrate(candle_handle hdev, uint8_t ch, uint32_t bitrate)
+{
+    // TODO ensure device is open, check channel count..
+    candle_device_t *dev = (candle_device_t*)hdev;
+
+    if (!bitrate) {
+        dev->last_error = CANDLE_ERR_BITRATE_UNSUPPORTED;
+        return false;
+    }
+
+    /* smallest prescaler with whole number of 8..25 time quanta, sample point at 75% */
+    for (uint32_t brp=1; brp<=32; brp++) {
+        uint32_t tq = dev->bt_const.fclk_can / (brp * bitrate);
+
+        if (tq * brp * bitrate != dev->bt_const.fclk_can || tq < 8 || tq > 25) {
+            continue;
+        }
+
+        candle_bittiming_t t;
+        uint32_t tseg1 = (tq * 3) / 4 - 1;
+        t.brp = brp;
+        t.prop_seg = 1;
+        t.phase_seg1 = tseg1 - t.prop_seg;
+        t.phase_seg2 = tq - 1 - tseg1;
+        t.sjw = t.phase_seg2 < 4 ? t.phase_seg2 : 4;
+
+        return candle_ctrl_set_data_bittiming(dev, ch, &t);
+    }
+
+    dev->last_error = CANDLE_ERR_BITRATE_UNSUPPORTED;
+    return false;
+}
+
+bool __stdcall DLL candle_channel_set_berr_reporting(candle_handle hdev, uint8_t ch, bool enable)
+{
+    candle_device_t *dev = (candle_device_t*)hdev;
+    if (ch > dev->dconf.icount) {
+        dev->last_error = CANDLE_ERR_CHANNEL_OUT_OF_RANGE;
+        return false;
+    }
+    return candle_ctrl_set_berr(dev, ch, enable ? 1 : 0);
+}
+
 bool __stdcall DLL candle_channel_start(candle_handle hdev, uint8_t ch, uint32_t flags)
 {
     // TODO ensure device is open, check channel count..
@@ -482,20 +532,33 @@ bool __stdcall DLL candle_channel_stop(candle_handle hdev, uint8_t ch)
 }
 
 bool __stdcall DLL candle_frame_send(candle_handle hdev, uint8_t ch, candle_frame_t *frame)
+{
+    return candle_frame_send_echo(hdev, ch, frame, 0);
+}
+
+bool __stdcall DLL candle_frame_send_echo(candle_handle hdev, uint8_t ch, candle_frame_t *frame, uint32_t echo_id)
 {
     // TODO ensure device is open, check channel count..
     candle_device_t *dev = (candle_device_t*)hdev;
 
     unsigned long bytes_sent = 0;
 
-    frame->echo_id = 0;
+    /* device returns echo_id in the echo frame once the frame is on the bus */
+    frame->echo_id = echo_id;
     frame->channel = ch;
 
+    /* classic frames only carry 8 data bytes on the wire */
+    uint8_t buf[sizeof(*frame)];
+    unsigned data_size = (frame->flags & CANDLE_FLAG_FD) ? CANDLE_FD_DATA_SIZE : CANDLE_CLASSIC_DATA_SIZE;
+    memcpy(buf, frame, CANDLE_FRAME_HEADER_SIZE);
+    memcpy(buf + CANDLE_FRAME_HEADER_SIZE, frame->data, data_size);
+    memset(buf + CANDLE_FRAME_HEADER_SIZE + data_size, 0, sizeof(frame->timestamp_us));
+
     bool rc = WinUsb_WritePipe(
         dev->winUSBHandle,
         dev->bulkOutPipe,
-        (uint8_t*)frame,
-        sizeof(*frame),
+        buf,
+        CANDLE_FRAME_HEADER_SIZE + data_size + sizeof(frame->timestamp_us),
         &bytes_sent,
         0
     );
@@ -530,17 +593,31 @@ bool __stdcall DLL candle_frame_read(candle_handle hdev, candle_frame_t *frame,
         return false;
     }
 
-    if (bytes_transfered < sizeof(*frame)-4) {
+    uint8_t *buf = dev->rxurbs[urb_num].buf;
+
+    if (bytes_transfered < CANDLE_FRAME_HEADER_SIZE + CANDLE_CLASSIC_DATA_SIZE) {
         candle_prepare_read(dev, urb_num);
         dev->last_error = CANDLE_ERR_READ_SIZE;
         return false;
     }
 
-    if (bytes_transfered < sizeof(*frame)) {
-        frame->timestamp_us = 0;
+    memcpy(frame, buf, CANDLE_FRAME_HEADER_SIZE);
+
+    /* FD frames carry 64 data bytes, timestamp follows data if enabled */
+    unsigned data_size = (frame->flags & CANDLE_FLAG_FD) ? CANDLE_FD_DATA_SIZE : CANDLE_CLASSIC_DATA_SIZE;
+    if (bytes_transfered < CANDLE_FRAME_HEADER_SIZE + data_size) {
+        candle_prepare_read(dev, urb_num);
+        dev->last_error = CANDLE_ERR_READ_SIZE;
+        return false;
     }
 
-    memcpy(frame, dev->rxurbs[urb_num].buf, sizeof(*frame));
+    memcpy(frame->data, buf + CANDLE_FRAME_HEADER_SIZE, data_size);
+
+    if (bytes_transfered >= CANDLE_FRAME_HEADER_SIZE + data_size + sizeof(frame->timestamp_us)) {
+        memcpy(&frame->timestamp_us, buf + CANDLE_FRAME_HEADER_SIZE + data_size, sizeof(frame->timestamp_us));
+    } else {
+        frame->timestamp_us = 0;
+    }
 
     return candle_prepare_read(dev, urb_num);
 }
@@ -573,11 +650,37 @@ bool __stdcall DLL candle_frame_is_rtr(candle_frame_t *frame)
     return (frame->can_id & CANDLE_ID_RTR) != 0;
 }
 
+bool __stdcall DLL candle_frame_is_fd(candle_frame_t *frame)
+{
+    return (frame->flags & CANDLE_FLAG_FD) != 0;
+}
+
 uint8_t __stdcall DLL candle_frame_dlc(candle_frame_t *frame)
 {
     return frame->can_dlc;
 }
 
+static const uint8_t candle_dlc_sizes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+uint8_t __stdcall DLL candle_frame_size(candle_frame_t *frame)
+{
+    if (frame->flags & CANDLE_FLAG_FD) {
+        return candle_dlc_sizes[frame->can_dlc & 0x0F];
+    }
+
+    /* classic DLC 9..15 still means 8 bytes */
+    return frame->can_dlc > 8 ? 8 : frame->can_dlc;
+}
+
+uint8_t __stdcall DLL candle_dlc_from_size(uint8_t size)
+{
+    uint8_t dlc = 0;
+    while (dlc < 15 && candle_dlc_sizes[dlc] < size) {
+        dlc++;
+    }
+    return dlc;
+}
+
 uint8_t* __stdcall DLL candle_frame_data(candle_frame_t *frame)
 {
     return frame->data;
@@ -49,6 +49,17 @@ enum {
     CANDLE_ID_ERR      = 0x20000000
 };
 
+enum {
+    CANDLE_FLAG_OVERFLOW = 0x01,
+    CANDLE_FLAG_FD       = 0x02,
+    CANDLE_FLAG_BRS      = 0x04,
+    CANDLE_FLAG_ESI      = 0x08
+};
+
+enum {
+    CANDLE_FEATURE_FD = 0x100
+};
+
 typedef enum {
     CANDLE_MODE_NORMAL        = 0x00,
     CANDLE_MODE_LISTEN_ONLY   = 0x01,
@@ -56,6 +67,8 @@ typedef enum {
     CANDLE_MODE_TRIPLE_SAMPLE = 0x04,
     CANDLE_MODE_ONE_SHOT      = 0x08,
     CANDLE_MODE_HW_TIMESTAMP  = 0x10,
+    CANDLE_MODE_FD            = 0x100,
+    CANDLE_MODE_BERR_REPORTING = 0x1000,
 } candle_mode_t;
 
 typedef enum {
@@ -88,7 +101,10 @@ typedef enum {
     CANDLE_ERR_SET_TIMESTAMP_MODE  = 26,
     CANDLE_ERR_DEV_OUT_OF_RANGE    = 27,
 	CANDLE_ERR_GET_TIMESTAMP       = 28,
-    CANDLE_ERR_SET_PIPE_RAW_IO     = 29
+    CANDLE_ERR_SET_PIPE_RAW_IO     = 29,
+    CANDLE_ERR_SET_DATA_BITTIMING  = 30,
+    CANDLE_ERR_SET_BERR            = 31,
+    CANDLE_ERR_CHANNEL_OUT_OF_RANGE = 32
 } candle_err_t;
 
 #pragma pack(push,1)
@@ -100,8 +116,10 @@ typedef struct {
     uint8_t channel;
     uint8_t flags;
     uint8_t reserved;
-    uint8_t data[8];
+    uint8_t data[64];
     uint32_t timestamp_us;
+    /* host time the frame was read (us), set by the caller, not the driver */
+    uint64_t host_timestamp_us;
 } candle_frame_t;
 
 typedef struct {
@@ -145,17 +163,24 @@ bool __stdcall DLL candle_channel_count(candle_handle hdev, uint8_t *num_channel
 bool __stdcall DLL candle_channel_get_capabilities(candle_handle hdev, uint8_t ch, candle_capability_t *cap);
 bool __stdcall DLL candle_channel_set_timing(candle_handle hdev, uint8_t ch, candle_bittiming_t *data);
 bool __stdcall DLL candle_channel_set_bitrate(candle_handle hdev, uint8_t ch, uint32_t bitrate);
+bool __stdcall DLL candle_channel_set_data_timing(candle_handle hdev, uint8_t ch, candle_bittiming_t *data);
+bool __stdcall DLL candle_channel_set_data_bitrate(candle_handle hdev, uint8_t ch, uint32_t bitrate);
+bool __stdcall DLL candle_channel_set_berr_reporting(candle_handle hdev, uint8_t ch, bool enable);
 bool __stdcall DLL candle_channel_start(candle_handle hdev, uint8_t ch, uint32_t flags);
 bool __stdcall DLL candle_channel_stop(candle_handle hdev, uint8_t ch);
 
 bool __stdcall DLL candle_frame_send(candle_handle hdev, uint8_t ch, candle_frame_t *frame);
+bool __stdcall DLL candle_frame_send_echo(candle_handle hdev, uint8_t ch, candle_frame_t *frame, uint32_t echo_id);
 bool __stdcall DLL candle_frame_read(candle_handle hdev, candle_frame_t *frame, uint32_t timeout_ms);
 
 candle_frametype_t __stdcall DLL candle_frame_type(candle_frame_t *frame);
 uint32_t __stdcall DLL candle_frame_id(candle_frame_t *frame);
 bool __stdcall DLL candle_frame_is_extended_id(candle_frame_t *frame);
 bool __stdcall DLL candle_frame_is_rtr(candle_frame_t *frame);
+bool __stdcall DLL candle_frame_is_fd(candle_frame_t *frame);
 uint8_t __stdcall DLL candle_frame_dlc(candle_frame_t *frame);
+uint8_t __stdcall DLL candle_frame_size(candle_frame_t *frame);
+uint8_t __stdcall DLL candle_dlc_from_size(uint8_t size);
 uint8_t* __stdcall DLL candle_frame_data(candle_frame_t *frame);
 uint32_t __stdcall DLL candle_frame_timestamp_us(candle_frame_t *frame);
 
@@ -38,6 +38,11 @@
 #define CANDLE_MAX_DEVICES 32
 #define CANDLE_URB_COUNT 30
 
+/* frames on the wire are header, 8 (classic) or 64 (FD) data bytes and optional timestamp */
+#define CANDLE_FRAME_HEADER_SIZE 12
+#define CANDLE_CLASSIC_DATA_SIZE 8
+#define CANDLE_FD_DATA_SIZE 64
+
 #pragma pack(push,1)
 
 typedef struct {
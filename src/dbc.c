@@ -0,0 +1,262 @@
+#include "dbc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#define DBC_LINE_SIZE 4096
+
+static uint64_t dbc_load_le(const uint8_t* p)
+{
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+static uint64_t dbc_load_be(const uint8_t* p)
+{
+  uint64_t v = 0;
+  for (int i = 0; i < 8; ++i)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+// Converts signal definition into byte offset, shift and mask
+static bool dbc_signal_compile(dbc_signal_t* signal)
+{
+  if (!signal->length || signal->length > 64)
+    return false;
+
+  signal->mask = signal->length == 64 ? ~0ULL : (1ULL << signal->length) - 1;
+
+  if (signal->big_endian) {
+    // Motorola start bit is MSB in sawtooth numbering, convert it to
+    // linear big endian bit index
+    uint32_t msb = (signal->start_bit/8)*8 + (7 - signal->start_bit%8);
+    signal->byte_offset = msb/8;
+    signal->bit_shift = msb%8;
+    signal->end_byte = (msb + signal->length - 1)/8 + 1;
+  } else {
+    signal->byte_offset = signal->start_bit/8;
+    signal->bit_shift = signal->start_bit%8;
+    signal->end_byte = (signal->start_bit + signal->length - 1)/8 + 1;
+  }
+
+  return signal->end_byte <= DBC_MAX_DATA;
+}
+
+uint64_t dbc_signal_raw(const dbc_signal_t* signal, const uint8_t* data)
+{
+  const uint8_t* p = data + signal->byte_offset;
+  uint32_t bits = signal->bit_shift + signal->length;
+  uint64_t v;
+
+  if (signal->big_endian) {
+    v = dbc_load_be(p);
+    if (bits <= 64)
+      v >>= 64 - bits;
+    else
+      v = (v << (bits - 64)) | (p[8] >> (72 - bits));
+  } else {
+    v = dbc_load_le(p) >> signal->bit_shift;
+    if (bits > 64)
+      v |= (uint64_t)p[8] << (64 - signal->bit_shift);
+  }
+
+  return v & signal->mask;
+}
+
+double dbc_signal_value(const dbc_signal_t* signal, const uint8_t* data, uint8_t len)
+{
+  // Signal does not fit in received frame
+  if (signal->end_byte > len)
+    return NAN;
+
+  uint64_t raw = dbc_signal_raw(signal, data);
+
+  if (signal->is_signed && (raw >> (signal->length - 1)) & 1)
+    return (double)(int64_t)(raw | ~signal->mask) * signal->factor + signal->offset;
+
+  return (double)raw * signal->factor + signal->offset;
+}
+
+static int dbc_message_cmp(const void* a, const void* b)
+{
+  uint32_t ia = ((const dbc_message_t*)a)->id;
+  uint32_t ib = ((const dbc_message_t*)b)->id;
+  return ia < ib ? -1 : ia > ib;
+}
+
+dbc_message_t* dbc_find_message(dbc_t* dbc, uint32_t can_id)
+{
+  dbc_message_t key;
+  key.id = can_id & DBC_ID_MASK;
+  return bsearch(&key, dbc->messages, dbc->message_count, sizeof(dbc_message_t), dbc_message_cmp);
+}
+
+static char* dbc_skip_space(char* p)
+{
+  while (isspace((unsigned char)*p))
+    ++p;
+  return p;
+}
+
+// Copies next whitespace or colon delimited token
+static char* dbc_token(char* p, char* token, size_t size)
+{
+  size_t len = 0;
+
+  p = dbc_skip_space(p);
+  while (*p && !isspace((unsigned char)*p) && *p != ':') {
+    if (len + 1 < size)
+      token[len++] = *p;
+    ++p;
+  }
+  token[len] = 0;
+
+  return p;
+}
+
+// Parses: BO_ <id> <name>: <size> <transmitter>
+static bool dbc_parse_message(char* p, dbc_message_t* msg)
+{
+  unsigned long id;
+  unsigned size;
+
+  memset(msg, 0, sizeof(dbc_message_t));
+  msg->multiplexor = -1;
+
+  id = strtoul(p, &p, 10);
+  p = dbc_token(p, msg->name, sizeof(msg->name));
+  p = dbc_skip_space(p);
+  if (*p++ != ':' || sscanf(p, "%u", &size) != 1)
+    return false;
+
+  msg->id = (uint32_t)id & DBC_ID_MASK;
+  msg->size = (uint8_t)size;
+
+  return true;
+}
+
+// Parses: SG_ <name> [M|m<value>] : <start>|<length>@<order><sign> (<factor>,<offset>) ...
+static bool dbc_parse_signal(char* p, dbc_signal_t* signal)
+{
+  char mux[16];
+  unsigned start, length;
+  char order, sign;
+
+  memset(signal, 0, sizeof(dbc_signal_t));
+
+  p = dbc_token(p, signal->name, sizeof(signal->name));
+  p = dbc_token(p, mux, sizeof(mux));
+
+  if (mux[0] == 'M') {
+    signal->mux = DBC_MUX_MULTIPLEXOR;
+  } else if (mux[0] == 'm') {
+    signal->mux = DBC_MUX_MULTIPLEXED;
+    signal->mux_value = strtoul(mux + 1, NULL, 10);
+  }
+
+  p = dbc_skip_space(p);
+  if (*p++ != ':')
+    return false;
+
+  if (sscanf(p, " %u|%u@%c%c (%lf,%lf)", &start, &length, &order, &sign, &signal->factor, &signal->offset) != 6)
+    return false;
+
+  signal->start_bit = (uint16_t)start;
+  signal->length = (uint16_t)length;
+  signal->big_endian = order == '0';
+  signal->is_signed = sign == '-';
+
+  return dbc_signal_compile(signal);
+}
+
+dbc_t* dbc_load(const char* path, char* error, size_t error_size)
+{
+  error[0] = 0;
+
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    snprintf(error, error_size, "Unable to open %s", path);
+    return NULL;
+  }
+
+  dbc_t* dbc = calloc(1, sizeof(dbc_t));
+  char* line = malloc(DBC_LINE_SIZE);
+  dbc_message_t* msg = NULL;
+  size_t line_num = 0;
+  bool ok = dbc && line;
+
+  while (ok && fgets(line, DBC_LINE_SIZE, f)) {
+    char* p = dbc_skip_space(line);
+    ++line_num;
+
+    if (!strncmp(p, "BO_ ", 4)) {
+      dbc_message_t* messages = realloc(dbc->messages, (dbc->message_count + 1)*sizeof(dbc_message_t));
+      if (!messages) {
+        ok = false;
+        break;
+      }
+
+      dbc->messages = messages;
+      msg = &dbc->messages[dbc->message_count];
+      if (!dbc_parse_message(p + 4, msg)) {
+        snprintf(error, error_size, "Invalid message definition at line %zu", line_num);
+        ok = false;
+        break;
+      }
+      dbc->message_count++;
+    } else if (!strncmp(p, "SG_ ", 4) && msg) {
+      dbc_signal_t* signals = realloc(msg->signals, (msg->signal_count + 1)*sizeof(dbc_signal_t));
+      if (!signals) {
+        ok = false;
+        break;
+      }
+
+      msg->signals = signals;
+      dbc_signal_t* signal = &msg->signals[msg->signal_count];
+      if (!dbc_parse_signal(p + 4, signal)) {
+        snprintf(error, error_size, "Invalid signal definition at line %zu", line_num);
+        ok = false;
+        break;
+      }
+
+      if (signal->mux == DBC_MUX_MULTIPLEXOR)
+        msg->multiplexor = (int)msg->signal_count;
+
+      msg->signal_count++;
+    } else if (*p && strncmp(p, "SG_ ", 4)) {
+      // Signals only follow their message
+      msg = NULL;
+    }
+  }
+
+  fclose(f);
+  free(line);
+
+  if (!ok) {
+    if (!error[0])
+      snprintf(error, error_size, "Out of memory");
+    dbc_free(dbc);
+    return NULL;
+  }
+
+  qsort(dbc->messages, dbc->message_count, sizeof(dbc_message_t), dbc_message_cmp);
+
+  return dbc;
+}
+
+void dbc_free(dbc_t* dbc)
+{
+  if (!dbc)
+    return;
+
+  for (size_t i = 0; i < dbc->message_count; ++i)
+    free(dbc->messages[i].signals);
+
+  free(dbc->messages);
+  free(dbc);
+}
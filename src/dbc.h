@@ -0,0 +1,70 @@
+#ifndef _DBC_H_
+#define _DBC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define DBC_MAX_NAME 128
+#define DBC_MAX_DATA 64
+// Frame data is copied into zero padded buffer so extraction can always load 8 bytes
+#define DBC_DATA_BUF_SIZE (DBC_MAX_DATA + 16)
+
+// DBC marks extended ids with bit 31, same as CANDLE_ID_EXTENDED
+#define DBC_ID_MASK 0x9FFFFFFF
+
+typedef enum {
+  DBC_MUX_NONE,
+  DBC_MUX_MULTIPLEXOR,
+  DBC_MUX_MULTIPLEXED,
+} dbc_mux_t;
+
+typedef struct dbc_signal_t {
+  char name[DBC_MAX_NAME];
+
+  // Definition as written in the DBC file
+  uint16_t start_bit;
+  uint16_t length;
+  bool big_endian;
+  bool is_signed;
+  double factor;
+  double offset;
+  uint8_t mux;
+  uint32_t mux_value;
+
+  // Precomputed extraction plan
+  uint16_t byte_offset;
+  uint8_t bit_shift;
+  uint16_t end_byte;
+  uint64_t mask;
+} dbc_signal_t;
+
+typedef struct dbc_message_t {
+  uint32_t id;
+  char name[DBC_MAX_NAME];
+  uint8_t size;
+
+  dbc_signal_t* signals;
+  size_t signal_count;
+
+  // Index of multiplexor signal or -1
+  int multiplexor;
+} dbc_message_t;
+
+typedef struct dbc_t {
+  // Sorted by id
+  dbc_message_t* messages;
+  size_t message_count;
+} dbc_t;
+
+// Returns NULL and fills error on failure
+dbc_t* dbc_load(const char* path, char* error, size_t error_size);
+void dbc_free(dbc_t* dbc);
+
+dbc_message_t* dbc_find_message(dbc_t* dbc, uint32_t can_id);
+
+// data must point to DBC_DATA_BUF_SIZE zero padded buffer
+uint64_t dbc_signal_raw(const dbc_signal_t* signal, const uint8_t* data);
+double dbc_signal_value(const dbc_signal_t* signal, const uint8_t* data, uint8_t len);
+
+#endif
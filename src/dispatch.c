@@ -0,0 +1,115 @@
+#include "dispatch.h"
+#include "candle_api/candle.h"
+#include <string.h>
+
+#define DISPATCH_EXT_MASK (DISPATCH_EXT_CAPACITY - 1)
+
+static size_t dispatch_ext_hash(uint32_t id)
+{
+  // Fibonacci hashing spreads sequential ids over the table, the top bits
+  // of the product are the well mixed ones
+  return (size_t)((uint32_t)(id * 0x9E3779B1u) >> (32 - DISPATCH_EXT_BITS));
+}
+
+// Finds route of 29 bit id by scanning ranges, newest first
+static uint16_t dispatch_ext_resolve(dispatch_t* dispatch, uint32_t id)
+{
+  for (size_t i = dispatch->route_count; i-- > 0;) {
+    dispatch_route_t* route = &dispatch->routes[i];
+    if (route->extended && id >= route->first && id <= route->last)
+      return (uint16_t)i;
+  }
+
+  return DISPATCH_NONE;
+}
+
+static void dispatch_rebuild(dispatch_t* dispatch)
+{
+  for (size_t id = 0; id < DISPATCH_STD_IDS; ++id)
+    dispatch->std[id] = DISPATCH_NONE;
+
+  // Later routes overwrite earlier ones
+  for (size_t i = 0; i < dispatch->route_count; ++i) {
+    dispatch_route_t* route = &dispatch->routes[i];
+    if (!route->extended) {
+      for (uint32_t id = route->first; id <= route->last; ++id)
+        dispatch->std[id] = (uint16_t)i;
+    }
+  }
+
+  // Invalidates all cached 29 bit lookups
+  dispatch->generation++;
+}
+
+// Precomputes map entries of single 29 bit ids, ranges are cached on lookup
+static void dispatch_rebuild_ext(dispatch_t* dispatch)
+{
+  for (size_t i = 0; i < dispatch->route_count; ++i) {
+    dispatch_route_t* route = &dispatch->routes[i];
+    if (route->extended && route->first == route->last)
+      dispatch_lookup(dispatch, route->first | CANDLE_ID_EXTENDED);
+  }
+}
+
+void dispatch_init(dispatch_t* dispatch)
+{
+  memset(dispatch, 0, sizeof(dispatch_t));
+  dispatch_rebuild(dispatch);
+}
+
+bool dispatch_add(dispatch_t* dispatch, uint32_t first, uint32_t last, bool extended, void* ctx)
+{
+  if (dispatch->route_count >= DISPATCH_MAX_ROUTES)
+    return false;
+
+  dispatch_route_t* route = &dispatch->routes[dispatch->route_count++];
+  route->first = first;
+  route->last = last;
+  route->extended = extended;
+  route->ctx = ctx;
+  route->calls = 0;
+  route->errors = 0;
+
+  dispatch_rebuild(dispatch);
+  dispatch_rebuild_ext(dispatch);
+  return true;
+}
+
+void dispatch_remove(dispatch_t* dispatch, size_t index)
+{
+  if (index >= dispatch->route_count)
+    return;
+
+  memmove(&dispatch->routes[index], &dispatch->routes[index + 1], (dispatch->route_count - index - 1)*sizeof(dispatch_route_t));
+  dispatch->route_count--;
+
+  dispatch_rebuild(dispatch);
+  dispatch_rebuild_ext(dispatch);
+}
+
+uint16_t dispatch_lookup(dispatch_t* dispatch, uint32_t can_id)
+{
+  if (!(can_id & CANDLE_ID_EXTENDED))
+    return dispatch->std[can_id & (DISPATCH_STD_IDS - 1)];
+
+  uint32_t id = can_id & 0x1FFFFFFF;
+  size_t index = dispatch_ext_hash(id);
+
+  for (size_t probe = 0; probe < DISPATCH_EXT_MAX_PROBES; ++probe) {
+    dispatch_ext_entry_t* entry = &dispatch->ext[(index + probe) & DISPATCH_EXT_MASK];
+
+    if (entry->generation == dispatch->generation && entry->id == id)
+      return entry->route;
+
+    // Free slot, cache result including misses so unrouted ids stay cheap
+    if (entry->generation != dispatch->generation) {
+      entry->id = id;
+      entry->route = dispatch_ext_resolve(dispatch, id);
+      entry->generation = dispatch->generation;
+      return entry->route;
+    }
+  }
+
+  // Map is crowded around this id, scan ranges every time
+  return dispatch_ext_resolve(dispatch, id);
+}
@@ -0,0 +1,59 @@
+#ifndef _DISPATCH_H_
+#define _DISPATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define DISPATCH_STD_IDS 2048
+#define DISPATCH_MAX_ROUTES 1024
+// Lookup result when no route matches
+#define DISPATCH_NONE UINT16_MAX
+// Size of the 29 bit id map, ids of ranges are cached there on first lookup
+#define DISPATCH_EXT_BITS 12
+#define DISPATCH_EXT_CAPACITY (1 << DISPATCH_EXT_BITS)
+#define DISPATCH_EXT_MAX_PROBES 16
+
+typedef struct dispatch_route_t {
+  // Inclusive range of 11 or 29 bit ids without flags
+  uint32_t first;
+  uint32_t last;
+  bool extended;
+
+  void* ctx;
+  uint64_t calls;
+  uint64_t errors;
+} dispatch_route_t;
+
+typedef struct dispatch_ext_entry_t {
+  // Entry is valid only when generation matches the table
+  uint32_t generation;
+  uint32_t id;
+  uint16_t route;
+} dispatch_ext_entry_t;
+
+// Routes CAN ids to handlers. The route registered last wins when ranges
+// overlap. Not thread safe, callers serialize all access
+typedef struct dispatch_t {
+  dispatch_route_t routes[DISPATCH_MAX_ROUTES];
+  size_t route_count;
+
+  // Route index per 11 bit id
+  uint16_t std[DISPATCH_STD_IDS];
+
+  // Open addressing map of 29 bit ids, rebuild bumps the generation
+  dispatch_ext_entry_t ext[DISPATCH_EXT_CAPACITY];
+  uint32_t generation;
+} dispatch_t;
+
+void dispatch_init(dispatch_t* dispatch);
+
+// Returns false if there are too many routes
+bool dispatch_add(dispatch_t* dispatch, uint32_t first, uint32_t last, bool extended, void* ctx);
+// Removes route, later routes move down by one index
+void dispatch_remove(dispatch_t* dispatch, size_t index);
+
+// Returns route index for can_id with CANDLE_ID_EXTENDED flag, or DISPATCH_NONE
+uint16_t dispatch_lookup(dispatch_t* dispatch, uint32_t can_id);
+
+#endif
@@ -0,0 +1,193 @@
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include "exporter.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EXPORTER_BUF_SIZE 65536
+#define EXPORTER_REQUEST_SIZE 4096
+#define EXPORTER_POLL_INTERVAL 100 // in ms
+#define EXPORTER_RECV_TIMEOUT 1000 // in ms
+
+struct exporter_t {
+  SOCKET sock;
+  HANDLE thread;
+  volatile bool stop_req;
+
+  exporter_render_t render;
+  void* ctx;
+
+  char* buf;
+};
+
+static const char exporter_ok_header[] =
+  "HTTP/1.0 200 OK\r\n"
+  "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+  "Connection: close\r\n"
+  "Content-Length: %zu\r\n"
+  "\r\n";
+
+static const char exporter_not_found[] =
+  "HTTP/1.0 404 Not Found\r\n"
+  "Connection: close\r\n"
+  "Content-Length: 0\r\n"
+  "\r\n";
+
+void exporter_printf(char* buf, size_t size, size_t* len, const char* format, ...)
+{
+  if (*len >= size)
+    return;
+
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf(buf + *len, size - *len, format, args);
+  va_end(args);
+
+  if (n > 0)
+    *len = *len + n < size ? *len + n : size - 1;
+}
+
+static bool exporter_send_all(SOCKET sock, const char* data, size_t len)
+{
+  while (len) {
+    int n = send(sock, data, (int)len, 0);
+    if (n <= 0)
+      return false;
+
+    data += n;
+    len -= n;
+  }
+
+  return true;
+}
+
+static void exporter_handle_client(exporter_t* exporter, SOCKET client)
+{
+  char request[EXPORTER_REQUEST_SIZE];
+  size_t len = 0;
+  DWORD timeout = EXPORTER_RECV_TIMEOUT;
+
+  setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+
+  // Only request line is needed, but read whole header so client does not get reset
+  while (len < sizeof(request) - 1) {
+    int n = recv(client, request + len, (int)(sizeof(request) - 1 - len), 0);
+    if (n <= 0)
+      break;
+
+    len += n;
+    request[len] = 0;
+    if (strstr(request, "\r\n\r\n"))
+      break;
+  }
+  request[len] = 0;
+
+  if (strncmp(request, "GET /metrics", 12) && strncmp(request, "GET / ", 6)) {
+    exporter_send_all(client, exporter_not_found, sizeof(exporter_not_found) - 1);
+    return;
+  }
+
+  size_t body_len = exporter->render(exporter->ctx, exporter->buf, EXPORTER_BUF_SIZE);
+
+  char header[sizeof(exporter_ok_header) + 32];
+  int header_len = snprintf(header, sizeof(header), exporter_ok_header, body_len);
+
+  if (exporter_send_all(client, header, header_len))
+    exporter_send_all(client, exporter->buf, body_len);
+}
+
+static DWORD WINAPI exporter_thread(LPVOID lpParam)
+{
+  exporter_t* exporter = (exporter_t*)lpParam;
+
+  while (!exporter->stop_req) {
+    fd_set readfds;
+    struct timeval tv = {0, EXPORTER_POLL_INTERVAL * 1000};
+
+    FD_ZERO(&readfds);
+    FD_SET(exporter->sock, &readfds);
+
+    // Wake periodically to check stop request
+    if (select(0, &readfds, NULL, NULL, &tv) <= 0)
+      continue;
+
+    SOCKET client = accept(exporter->sock, NULL, NULL);
+    if (client == INVALID_SOCKET)
+      continue;
+
+    exporter_handle_client(exporter, client);
+
+    shutdown(client, SD_SEND);
+    closesocket(client);
+  }
+
+  return 0;
+}
+
+exporter_t* exporter_create(const char* address, uint16_t port, exporter_render_t render, void* ctx)
+{
+  WSADATA wsa;
+  struct sockaddr_in addr;
+
+  if (WSAStartup(MAKEWORD(2, 2), &wsa))
+    return NULL;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+
+  if (inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+    WSACleanup();
+    return NULL;
+  }
+
+  exporter_t* exporter = calloc(1, sizeof(exporter_t));
+  if (!exporter) {
+    WSACleanup();
+    return NULL;
+  }
+
+  exporter->render = render;
+  exporter->ctx = ctx;
+  exporter->buf = malloc(EXPORTER_BUF_SIZE);
+  exporter->sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+  if (!exporter->buf || exporter->sock == INVALID_SOCKET ||
+      bind(exporter->sock, (struct sockaddr*)&addr, sizeof(addr)) ||
+      listen(exporter->sock, SOMAXCONN)) {
+    exporter_delete(exporter);
+    return NULL;
+  }
+
+  DWORD id;
+  exporter->thread = CreateThread(NULL, 0, exporter_thread, (PVOID)exporter, 0, &id);
+  if (!exporter->thread) {
+    exporter_delete(exporter);
+    return NULL;
+  }
+
+  return exporter;
+}
+
+void exporter_delete(exporter_t* exporter)
+{
+  if (!exporter)
+    return;
+
+  if (exporter->thread) {
+    exporter->stop_req = true;
+    WaitForSingleObject(exporter->thread, INFINITE);
+    CloseHandle(exporter->thread);
+  }
+
+  if (exporter->sock != INVALID_SOCKET)
+    closesocket(exporter->sock);
+
+  free(exporter->buf);
+  free(exporter);
+
+  WSACleanup();
+}
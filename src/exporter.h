@@ -0,0 +1,23 @@
+#ifndef _EXPORTER_H_
+#define _EXPORTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Writes metrics in Prometheus text format into buf, returns length.
+// Called from the exporter thread, must not touch the GIL
+typedef size_t (*exporter_render_t)(void* ctx, char* buf, size_t size);
+
+// Minimal HTTP server answering GET /metrics. Opaque so winsock2.h does not
+// leak into modules that include windows.h first
+typedef struct exporter_t exporter_t;
+
+// Returns NULL when socket can not be bound
+exporter_t* exporter_create(const char* address, uint16_t port, exporter_render_t render, void* ctx);
+void exporter_delete(exporter_t* exporter);
+
+// snprintf that appends to buf at *len and never overflows
+void exporter_printf(char* buf, size_t size, size_t* len, const char* format, ...);
+
+#endif
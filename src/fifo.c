@@ -15,10 +15,15 @@ fifo_t* fifo_create(size_t element_size, size_t element_count)
   fifo->element_size = element_size;
   fifo->element_count = element_count;
   fifo->stored_count = 0;
+  fifo->overwrite_count = 0;
+  fifo->high_water = 0;
 
   InitializeConditionVariable(&fifo->buf_not_empty);
   InitializeConditionVariable(&fifo->buf_not_full);
   InitializeSRWLock(&fifo->lock);
+  fifo->ready_event = CreateEvent(NULL, true, false, NULL);
+  fifo->ready_callback = NULL;
+  fifo->ready_ctx = NULL;
 
   return fifo;
 }
@@ -31,6 +36,7 @@ bool fifo_delete(fifo_t* fifo)
   WakeAllConditionVariable(&fifo->buf_not_empty);
   WakeAllConditionVariable(&fifo->buf_not_full);
 
+  CloseHandle(fifo->ready_event);
   free(fifo->buf);
   free(fifo);
 
@@ -44,6 +50,16 @@ void fifo_inc_write_pointer(fifo_t* fifo)
     fifo->write_pointer = fifo->buf;
 
   fifo->stored_count++;
+
+  // Only empty to non-empty transition is signalled, waiters check stored_count
+  if (fifo->stored_count == 1) {
+    SetEvent(fifo->ready_event);
+    if (fifo->ready_callback)
+      fifo->ready_callback(fifo->ready_ctx);
+  }
+
+  if (fifo->stored_count > fifo->high_water)
+    fifo->high_water = fifo->stored_count;
 }
 
 void fifo_inc_read_pointer(fifo_t* fifo)
@@ -55,11 +71,34 @@ void fifo_inc_read_pointer(fifo_t* fifo)
   fifo->stored_count--;
 }
 
+// Called by readers with the lock held, writers set the event again on the
+// next empty to non-empty transition
+static void fifo_check_drained(fifo_t* fifo)
+{
+  if (!fifo->stored_count)
+    ResetEvent(fifo->ready_event);
+}
+
 bool fifo_is_full(fifo_t* fifo)
 {
   return fifo->stored_count >= fifo->element_count;
 }
 
+void fifo_set_ready_callback(fifo_t* fifo, void (*callback)(void* ctx), void* ctx)
+{
+  AcquireSRWLockExclusive(&fifo->lock);
+  fifo->ready_ctx = ctx;
+  fifo->ready_callback = callback;
+  ReleaseSRWLockExclusive(&fifo->lock);
+}
+
+void fifo_reset_high_water(fifo_t* fifo)
+{
+  AcquireSRWLockExclusive(&fifo->lock);
+  fifo->high_water = fifo->stored_count;
+  ReleaseSRWLockExclusive(&fifo->lock);
+}
+
 bool fifo_add(fifo_t* fifo, const void* item, uint32_t timeout)
 {
   AcquireSRWLockExclusive(&fifo->lock);
@@ -88,8 +127,10 @@ bool fifo_add_force(fifo_t* fifo, const void* item)
 {
   AcquireSRWLockExclusive(&fifo->lock);
 
-  if (fifo_is_full(fifo))
+  if (fifo_is_full(fifo)) {
     fifo_inc_read_pointer(fifo);
+    fifo->overwrite_count++;
+  }
 
   memcpy(fifo->write_pointer, item, fifo->element_size);
   fifo_inc_write_pointer(fifo);
@@ -117,6 +158,7 @@ bool fifo_get(fifo_t* fifo, void* item, uint32_t timeout)
 
   memcpy(item, fifo->read_pointer, fifo->element_size);
   fifo_inc_read_pointer(fifo);
+  fifo_check_drained(fifo);
 
   ReleaseSRWLockExclusive(&fifo->lock);
 
@@ -126,6 +168,47 @@ bool fifo_get(fifo_t* fifo, void* item, uint32_t timeout)
   return true;
 }
 
+size_t fifo_get_many(fifo_t* fifo, void* items, size_t max_count, uint32_t timeout)
+{
+  if (!max_count)
+    return 0;
+
+  AcquireSRWLockExclusive(&fifo->lock);
+
+  if (!fifo->stored_count) {
+    // Wait for not empty condition
+    if (!SleepConditionVariableSRW(&fifo->buf_not_empty, &fifo->lock, timeout, 0)) {
+      // Return if timeouted
+      ReleaseSRWLockExclusive(&fifo->lock);
+      return 0;
+    }
+  }
+
+  size_t count = fifo->stored_count < max_count ? fifo->stored_count : max_count;
+  size_t size = count*fifo->element_size;
+
+  // Stored items may wrap around the end of the buffer
+  size_t first = (uint8_t*)fifo->buf_end - (uint8_t*)fifo->read_pointer;
+  if (first > size)
+    first = size;
+
+  memcpy(items, fifo->read_pointer, first);
+  memcpy((uint8_t*)items + first, fifo->buf, size - first);
+
+  fifo->read_pointer = (uint8_t*)fifo->read_pointer + size;
+  if (fifo->read_pointer >= fifo->buf_end)
+    fifo->read_pointer = (uint8_t*)fifo->read_pointer - (fifo->element_size*fifo->element_count);
+  fifo->stored_count -= count;
+  fifo_check_drained(fifo);
+
+  ReleaseSRWLockExclusive(&fifo->lock);
+
+  // Wake any waiting write
+  WakeConditionVariable(&fifo->buf_not_full);
+
+  return count;
+}
+
 // Optimised unsafe funtions
 void* fifo_add_acquire(fifo_t* fifo)
 {
@@ -179,8 +262,10 @@ bool fifo_add_commit_force(fifo_t* fifo, void* item)
     return false;
   }
 
-  if (fifo_is_full(fifo))
+  if (fifo_is_full(fifo)) {
     fifo_inc_read_pointer(fifo);
+    fifo->overwrite_count++;
+  }
 
   fifo_inc_write_pointer(fifo);
 
@@ -18,10 +18,21 @@ typedef struct fifo_t {
   void* read_pointer;
   void* buf_end;
 
+  // Statistics (updated under lock)
+  uint64_t overwrite_count;
+  size_t high_water;
+
   // Thread synchronization
   CONDITION_VARIABLE buf_not_empty;
   CONDITION_VARIABLE buf_not_full;
   SRWLOCK lock;
+
+  // Manual reset event set while fifo is non-empty, lets any number of
+  // threads wait on several fifos with WaitForMultipleObjects
+  HANDLE ready_event;
+  // Optional callback on the same transition, called with the lock held
+  void (*ready_callback)(void* ctx);
+  void* ready_ctx;
 } fifo_t;
 
 fifo_t* fifo_create(size_t element_size, size_t element_count);
@@ -29,12 +40,20 @@ bool fifo_delete(fifo_t* fifo);
 
 bool fifo_is_full(fifo_t* fifo);
 
+// Installs callback called when fifo becomes non-empty
+void fifo_set_ready_callback(fifo_t* fifo, void (*callback)(void* ctx), void* ctx);
+
+// Restarts high water mark tracking from current fill level
+void fifo_reset_high_water(fifo_t* fifo);
+
 // Returns false if fifo is full
 bool fifo_add(fifo_t* fifo, const void* item, uint32_t timeout);
 // Removes oldest item if fifo is full
 bool fifo_add_force(fifo_t* fifo, const void* item);
 
 bool fifo_get(fifo_t* fifo, void* item, uint32_t timeout);
+// Waits for at least one item and returns as many as available (up to max_count)
+size_t fifo_get_many(fifo_t* fifo, void* items, size_t max_count, uint32_t timeout);
 
 // Optimised unsafe funtions
 void* fifo_add_acquire(fifo_t* fifo);
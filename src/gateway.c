@@ -0,0 +1,320 @@
+#include "gateway.h"
+#include "broadcast.h"
+#include "timing.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Frames taken from the ring at once
+#define GATEWAY_READ_BATCH 32
+
+struct gateway_t {
+  broadcast_t* ring;
+  uint64_t overruns;
+
+  HANDLE thread;
+  volatile bool stop_req;
+
+  // Held shared by the gateway thread while it processes a batch
+  SRWLOCK lock;
+  gateway_route_t routes[GATEWAY_MAX_ROUTES];
+  size_t route_count;
+  uint32_t next_id;
+
+  gateway_send_t send;
+
+  // Source channel, frames forwarded from it are not hops when it sees
+  // them again
+  void* src_ctx;
+  uint8_t src_ch;
+};
+
+// Recently forwarded frames of all gateways. A frame that shows up on
+// another source was forwarded onto a bus that is routed back, like a loop
+// between two adapters on the same buses
+typedef struct gateway_hop_entry_t {
+  uint64_t time_us;
+  uint64_t data_hash;
+  void* src_ctx;
+  uint32_t can_id;
+  uint8_t src_ch;
+  uint8_t can_dlc;
+  uint8_t hops;
+} gateway_hop_entry_t;
+
+static gateway_hop_entry_t gateway_hop_table[GATEWAY_HOP_TABLE_SIZE];
+static SRWLOCK gateway_hop_lock = SRWLOCK_INIT;
+
+static uint64_t gateway_frame_hash(candle_frame_t* frame)
+{
+  // FNV-1a over id, dlc and data
+  uint64_t hash = 14695981039346656037ull;
+  uint8_t size = candle_frame_size(frame);
+
+  hash = (hash ^ frame->can_id) * 1099511628211ull;
+  hash = (hash ^ frame->can_dlc) * 1099511628211ull;
+  for (uint8_t i = 0; i < size; ++i)
+    hash = (hash ^ frame->data[i]) * 1099511628211ull;
+
+  return hash;
+}
+
+static uint8_t gateway_hops(gateway_t* gateway, candle_frame_t* frame, uint64_t hash, uint64_t now)
+{
+  uint8_t hops = 0;
+
+  AcquireSRWLockShared(&gateway_hop_lock);
+  gateway_hop_entry_t* entry = &gateway_hop_table[hash % GATEWAY_HOP_TABLE_SIZE];
+  if (entry->data_hash == hash && entry->can_id == frame->can_id && entry->can_dlc == frame->can_dlc &&
+      now - entry->time_us < GATEWAY_HOP_WINDOW_US &&
+      (entry->src_ctx != gateway->src_ctx || entry->src_ch != gateway->src_ch))
+    hops = entry->hops;
+  ReleaseSRWLockShared(&gateway_hop_lock);
+
+  return hops;
+}
+
+static void gateway_record_hop(gateway_t* gateway, candle_frame_t* frame, uint8_t hops, uint64_t now)
+{
+  uint64_t hash = gateway_frame_hash(frame);
+
+  AcquireSRWLockExclusive(&gateway_hop_lock);
+  gateway_hop_entry_t* entry = &gateway_hop_table[hash % GATEWAY_HOP_TABLE_SIZE];
+  entry->time_us = now;
+  entry->data_hash = hash;
+  entry->src_ctx = gateway->src_ctx;
+  entry->src_ch = gateway->src_ch;
+  entry->can_id = frame->can_id;
+  entry->can_dlc = frame->can_dlc;
+  entry->hops = hops;
+  ReleaseSRWLockExclusive(&gateway_hop_lock);
+}
+
+static uint32_t gateway_apply_op(uint8_t op, uint32_t value, uint32_t operand)
+{
+  switch (op) {
+    case GATEWAY_OP_AND: return value & operand;
+    case GATEWAY_OP_OR: return value | operand;
+    case GATEWAY_OP_XOR: return value ^ operand;
+    default: return operand;
+  }
+}
+
+static void gateway_modify(const gateway_route_t* route, candle_frame_t* frame)
+{
+  for (uint8_t i = 0; i < route->mod_count; ++i) {
+    const gateway_mod_t* mod = &route->mods[i];
+
+    switch (mod->target) {
+      case GATEWAY_TARGET_ID:
+        frame->can_id = gateway_apply_op(mod->op, frame->can_id, mod->value);
+        break;
+      case GATEWAY_TARGET_DLC:
+        frame->can_dlc = (uint8_t)gateway_apply_op(mod->op, frame->can_dlc, mod->value) & 0x0F;
+        // Classic frames carry at most 8 bytes
+        if (!(frame->flags & CANDLE_FLAG_FD) && frame->can_dlc > 8)
+          frame->can_dlc = 8;
+        break;
+      case GATEWAY_TARGET_DATA:
+        for (uint8_t j = 0; j < mod->len && j < sizeof(frame->data); ++j)
+          frame->data[j] = (uint8_t)gateway_apply_op(mod->op, frame->data[j], mod->data[j]);
+        break;
+    }
+  }
+}
+
+static bool gateway_take_token(gateway_route_t* route, uint64_t now)
+{
+  if (!route->rate)
+    return true;
+
+  route->tokens += (now - route->refill_time_us) * route->rate / 1e6;
+  if (route->tokens > route->burst)
+    route->tokens = route->burst;
+  route->refill_time_us = now;
+
+  if (route->tokens < 1)
+    return false;
+
+  route->tokens -= 1;
+  return true;
+}
+
+static void gateway_forward(gateway_t* gateway, candle_frame_t* frame)
+{
+  uint64_t now = timing_now_us();
+  uint8_t hops = gateway_hops(gateway, frame, gateway_frame_hash(frame), now);
+
+  for (size_t i = 0; i < gateway->route_count; ++i) {
+    gateway_route_t* route = &gateway->routes[i];
+
+    if ((frame->can_id & route->mask) != (route->can_id & route->mask))
+      continue;
+
+    route->matched++;
+
+    if (hops >= route->max_hops) {
+      route->hop_limited++;
+      continue;
+    }
+
+    if (!gateway_take_token(route, now)) {
+      route->rate_limited++;
+      continue;
+    }
+
+    candle_frame_t out = *frame;
+    gateway_modify(route, &out);
+    out.channel = route->dst_ch;
+
+    if (gateway->send(route->dst_ctx, &out)) {
+      route->forwarded++;
+      gateway_record_hop(gateway, &out, hops + 1, now);
+    } else {
+      route->send_errors++;
+    }
+  }
+}
+
+static DWORD WINAPI gateway_thread(LPVOID lpParam)
+{
+  gateway_t* gateway = (gateway_t*)lpParam;
+  candle_frame_t frames[GATEWAY_READ_BATCH];
+  int64_t cursor = broadcast_tail(gateway->ring);
+
+  while (!gateway->stop_req) {
+    size_t count = broadcast_read(gateway->ring, &cursor, frames, GATEWAY_READ_BATCH, GATEWAY_POLL_INTERVAL, &gateway->overruns);
+    if (!count)
+      continue;
+
+    // Route counters are only written here, under the shared lock
+    AcquireSRWLockShared(&gateway->lock);
+    for (size_t i = 0; i < count; ++i)
+      gateway_forward(gateway, &frames[i]);
+    ReleaseSRWLockShared(&gateway->lock);
+  }
+
+  return 0;
+}
+
+gateway_t* gateway_create(gateway_send_t send, void* src_ctx, uint8_t src_ch)
+{
+  gateway_t* gateway = calloc(1, sizeof(gateway_t));
+  if (!gateway)
+    return NULL;
+
+  InitializeSRWLock(&gateway->lock);
+  gateway->next_id = 1;
+  gateway->send = send;
+  gateway->src_ctx = src_ctx;
+  gateway->src_ch = src_ch;
+  gateway->ring = broadcast_create(sizeof(candle_frame_t), GATEWAY_RING_SIZE);
+
+  DWORD id;
+  if (gateway->ring)
+    gateway->thread = CreateThread(NULL, 0, gateway_thread, (PVOID)gateway, 0, &id);
+
+  if (!gateway->thread) {
+    gateway_delete(gateway);
+    return NULL;
+  }
+
+  return gateway;
+}
+
+void gateway_delete(gateway_t* gateway)
+{
+  if (!gateway)
+    return;
+
+  if (gateway->thread) {
+    gateway->stop_req = true;
+    WaitForSingleObject(gateway->thread, INFINITE);
+    CloseHandle(gateway->thread);
+  }
+
+  broadcast_delete(gateway->ring);
+  free(gateway);
+}
+
+void gateway_push(gateway_t* gateway, const candle_frame_t* frame)
+{
+  broadcast_write(gateway->ring, frame);
+}
+
+uint32_t gateway_add(gateway_t* gateway, const gateway_route_t* route)
+{
+  uint32_t id = 0;
+
+  AcquireSRWLockExclusive(&gateway->lock);
+
+  if (gateway->route_count < GATEWAY_MAX_ROUTES) {
+    gateway_route_t* added = &gateway->routes[gateway->route_count++];
+    *added = *route;
+
+    id = added->id = gateway->next_id++;
+    added->tokens = route->burst;
+    added->refill_time_us = timing_now_us();
+    added->matched = 0;
+    added->forwarded = 0;
+    added->rate_limited = 0;
+    added->hop_limited = 0;
+    added->send_errors = 0;
+  }
+
+  ReleaseSRWLockExclusive(&gateway->lock);
+
+  return id;
+}
+
+bool gateway_remove(gateway_t* gateway, uint32_t id, void** dst_ctx)
+{
+  bool res = false;
+
+  // Exclusive lock waits for the batch in progress, so the destination is
+  // no longer used when this returns
+  AcquireSRWLockExclusive(&gateway->lock);
+
+  for (size_t i = 0; i < gateway->route_count; ++i) {
+    if (gateway->routes[i].id == id) {
+      *dst_ctx = gateway->routes[i].dst_ctx;
+      memmove(&gateway->routes[i], &gateway->routes[i + 1], (gateway->route_count - i - 1)*sizeof(gateway_route_t));
+      gateway->route_count--;
+      res = true;
+      break;
+    }
+  }
+
+  ReleaseSRWLockExclusive(&gateway->lock);
+
+  return res;
+}
+
+size_t gateway_routes(gateway_t* gateway, gateway_route_t* routes, size_t max_count, bool reset)
+{
+  // Exclusive so counters are consistent and can be reset
+  AcquireSRWLockExclusive(&gateway->lock);
+
+  size_t count = gateway->route_count < max_count ? gateway->route_count : max_count;
+  memcpy(routes, gateway->routes, count*sizeof(gateway_route_t));
+
+  if (reset) {
+    for (size_t i = 0; i < gateway->route_count; ++i) {
+      gateway_route_t* route = &gateway->routes[i];
+      route->matched = 0;
+      route->forwarded = 0;
+      route->rate_limited = 0;
+      route->hop_limited = 0;
+      route->send_errors = 0;
+    }
+  }
+
+  ReleaseSRWLockExclusive(&gateway->lock);
+
+  return count;
+}
+
+uint64_t gateway_overruns(gateway_t* gateway)
+{
+  return gateway->overruns;
+}
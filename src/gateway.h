@@ -0,0 +1,96 @@
+#ifndef _GATEWAY_H_
+#define _GATEWAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "candle_api/candle.h"
+
+#define GATEWAY_MAX_ROUTES 32
+#define GATEWAY_MAX_MODS 8
+// Frames waiting for the gateway thread, RX thread never blocks on it
+#define GATEWAY_RING_SIZE 1024
+#define GATEWAY_POLL_INTERVAL 100 // in ms
+// Forwarded frames seen on another source within this time count as a hop
+#define GATEWAY_HOP_WINDOW_US 100000
+#define GATEWAY_HOP_TABLE_SIZE 1024
+
+typedef enum {
+  GATEWAY_OP_AND,
+  GATEWAY_OP_OR,
+  GATEWAY_OP_XOR,
+  GATEWAY_OP_SET,
+} gateway_op_t;
+
+typedef enum {
+  GATEWAY_TARGET_ID,
+  GATEWAY_TARGET_DLC,
+  GATEWAY_TARGET_DATA,
+} gateway_target_t;
+
+// Modification like cangw -m. Id operations work on can_id including the
+// CANDLE_ID_* flags, data operations on the first len bytes
+typedef struct gateway_mod_t {
+  uint8_t op;
+  uint8_t target;
+  uint8_t len;
+  uint32_t value;
+  uint8_t data[64];
+} gateway_mod_t;
+
+typedef struct gateway_route_t {
+  // Assigned by gateway_add, stays the same when other routes are removed
+  uint32_t id;
+
+  // Frame matches if (can_id & mask) == (route can_id & mask)
+  uint32_t can_id;
+  uint32_t mask;
+
+  gateway_mod_t mods[GATEWAY_MAX_MODS];
+  uint8_t mod_count;
+
+  // Destination passed to the send callback with frame channel set to dst_ch
+  void* dst_ctx;
+  uint8_t dst_ch;
+
+  // Token bucket in frames per second, 0 is unlimited
+  uint32_t rate;
+  uint32_t burst;
+  double tokens;
+  uint64_t refill_time_us;
+
+  // Frames already forwarded this many times are dropped
+  uint8_t max_hops;
+
+  uint64_t matched;
+  uint64_t forwarded;
+  uint64_t rate_limited;
+  uint64_t hop_limited;
+  uint64_t send_errors;
+} gateway_route_t;
+
+// Sends frame on the destination, called on the gateway thread
+typedef bool (*gateway_send_t)(void* ctx, const void* frame);
+
+// Routes frames received on one channel to other channels. Frames pushed
+// by the RX thread are matched, modified and sent on a gateway thread.
+typedef struct gateway_t gateway_t;
+
+// Source identifies the channel in the same terms as route destinations
+gateway_t* gateway_create(gateway_send_t send, void* src_ctx, uint8_t src_ch);
+void gateway_delete(gateway_t* gateway);
+
+// Queues received frame, called by the single RX thread
+void gateway_push(gateway_t* gateway, const candle_frame_t* frame);
+
+// Returns route id, 0 if there are too many routes
+uint32_t gateway_add(gateway_t* gateway, const gateway_route_t* route);
+// Returns false if id is unknown, dst_ctx of the removed route otherwise
+bool gateway_remove(gateway_t* gateway, uint32_t id, void** dst_ctx);
+
+// Copies routes including counters, returns their count
+size_t gateway_routes(gateway_t* gateway, gateway_route_t* routes, size_t max_count, bool reset);
+// Frames overwritten in the ring before the gateway thread got them
+uint64_t gateway_overruns(gateway_t* gateway);
+
+#endif
@@ -0,0 +1,87 @@
+#include "histogram.h"
+#include <string.h>
+
+// Index of the highest set bit, v must not be 0
+static uint32_t histogram_msb(uint32_t v)
+{
+  uint32_t n = 0;
+
+  if (v >= 1u << 16) { v >>= 16; n += 16; }
+  if (v >= 1u << 8) { v >>= 8; n += 8; }
+  if (v >= 1u << 4) { v >>= 4; n += 4; }
+  if (v >= 1u << 2) { v >>= 2; n += 2; }
+  if (v >= 1u << 1) { n += 1; }
+
+  return n;
+}
+
+static uint32_t histogram_index(uint64_t value)
+{
+  if (value > UINT32_MAX)
+    return HISTOGRAM_BUCKET_COUNT - 1;
+
+  uint32_t v = (uint32_t)value;
+
+  // Values below first sub bucket range are stored exactly
+  if (v < HISTOGRAM_SUB_COUNT)
+    return v;
+
+  uint32_t msb = histogram_msb(v);
+  uint32_t sub = (v >> (msb - HISTOGRAM_SUB_BITS)) - HISTOGRAM_SUB_COUNT;
+
+  return (msb - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT + sub;
+}
+
+// Highest value stored in bucket
+static uint64_t histogram_bucket_max(uint32_t index)
+{
+  if (index < HISTOGRAM_SUB_COUNT)
+    return index;
+
+  uint32_t shift = index / HISTOGRAM_SUB_COUNT - 1;
+  uint64_t sub = index % HISTOGRAM_SUB_COUNT + HISTOGRAM_SUB_COUNT;
+
+  return ((sub + 1) << shift) - 1;
+}
+
+void histogram_reset(histogram_t* hist)
+{
+  memset((void*)hist, 0, sizeof(histogram_t));
+}
+
+void histogram_record(histogram_t* hist, uint64_t value)
+{
+  hist->counts[histogram_index(value)]++;
+  hist->count++;
+
+  if (value > hist->max)
+    hist->max = value;
+}
+
+uint64_t histogram_percentile(const histogram_t* hist, double percentile)
+{
+  uint64_t total = 0;
+
+  for (uint32_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i)
+    total += hist->counts[i];
+
+  if (!total)
+    return 0;
+
+  // Rank of the sample, rounded up so p100 is the last sample
+  uint64_t rank = (uint64_t)(percentile / 100.0 * total + 0.999999);
+  if (rank < 1)
+    rank = 1;
+
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+    seen += hist->counts[i];
+    if (seen >= rank) {
+      // Last bucket also holds values beyond 32 bit range
+      uint64_t value = histogram_bucket_max(i);
+      return value < hist->max && i < HISTOGRAM_BUCKET_COUNT - 1 ? value : hist->max;
+    }
+  }
+
+  return hist->max;
+}
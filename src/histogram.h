@@ -0,0 +1,28 @@
+#ifndef _HISTOGRAM_H_
+#define _HISTOGRAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// HDR style histogram: every power of two range is split into
+// HISTOGRAM_SUB_COUNT linear buckets, so relative error stays below 1/32
+// from 1us up to the 32 bit range (~71 minutes)
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKET_COUNT ((32 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT)
+
+// Single writer, readers take a copy. Reset races with the writer may lose
+// a few samples, which is acceptable for statistics
+typedef struct histogram_t {
+  volatile uint32_t counts[HISTOGRAM_BUCKET_COUNT];
+  volatile uint64_t count;
+  volatile uint64_t max;
+} histogram_t;
+
+void histogram_reset(histogram_t* hist);
+void histogram_record(histogram_t* hist, uint64_t value);
+
+// Returns highest value equivalent to the given percentile (0-100)
+uint64_t histogram_percentile(const histogram_t* hist, double percentile);
+
+#endif
@@ -0,0 +1,103 @@
+#include "id_stats.h"
+#include <stdlib.h>
+
+static size_t id_stats_hash(const id_stats_t* stats, uint32_t can_id)
+{
+  // Fibonacci hashing spreads sequential ids over the table
+  return (size_t)((can_id * 0x9E3779B1u) >> 8) & stats->mask;
+}
+
+size_t id_stats_table_size(size_t capacity)
+{
+  size_t size = 16;
+  while (size < capacity)
+    size <<= 1;
+
+  return size;
+}
+
+id_stats_t* id_stats_create(size_t capacity)
+{
+  size_t size = id_stats_table_size(capacity);
+
+  id_stats_t* stats = malloc(sizeof(id_stats_t));
+  if (!stats)
+    return NULL;
+
+  stats->entries = calloc(size, sizeof(id_stats_entry_t));
+  if (!stats->entries) {
+    free(stats);
+    return NULL;
+  }
+
+  // Zeroed entries have generation 0 so they start invalid
+  stats->generation = 1;
+  stats->capacity = size;
+  stats->mask = size - 1;
+  stats->dropped = 0;
+
+  return stats;
+}
+
+void id_stats_delete(id_stats_t* stats)
+{
+  if (!stats)
+    return;
+
+  free(stats->entries);
+  free(stats);
+}
+
+void id_stats_reset(id_stats_t* stats)
+{
+  stats->dropped = 0;
+  stats->generation++;
+}
+
+void id_stats_update(id_stats_t* stats, uint32_t can_id, uint32_t timestamp_us)
+{
+  uint32_t generation = stats->generation;
+  size_t index = id_stats_hash(stats, can_id);
+
+  for (size_t probe = 0; probe < ID_STATS_MAX_PROBES && probe < stats->capacity; ++probe) {
+    id_stats_entry_t* entry = &stats->entries[(index + probe) & stats->mask];
+
+    // Stale entries are free since reset invalidates all of them at once
+    if (entry->generation != generation) {
+      entry->can_id = can_id;
+      entry->count = 1;
+      entry->last_timestamp_us = timestamp_us;
+      entry->min_interval_us = UINT32_MAX;
+      entry->max_interval_us = 0;
+      entry->period_us = 0;
+      entry->jitter_us = 0;
+      entry->generation = generation;
+      return;
+    }
+
+    if (entry->can_id != can_id)
+      continue;
+
+    uint32_t interval = timestamp_us - entry->last_timestamp_us;
+
+    if (interval < entry->min_interval_us)
+      entry->min_interval_us = interval;
+    if (interval > entry->max_interval_us)
+      entry->max_interval_us = interval;
+
+    // First interval initializes the average
+    if (entry->count == 1) {
+      entry->period_us = interval;
+    } else {
+      double deviation = interval - entry->period_us;
+      entry->period_us += deviation / (1 << ID_STATS_EWMA_SHIFT);
+      entry->jitter_us += ((deviation < 0 ? -deviation : deviation) - entry->jitter_us) / (1 << ID_STATS_EWMA_SHIFT);
+    }
+
+    entry->count++;
+    entry->last_timestamp_us = timestamp_us;
+    return;
+  }
+
+  stats->dropped++;
+}
@@ -0,0 +1,53 @@
+#ifndef _ID_STATS_H_
+#define _ID_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ID_STATS_DEFAULT_CAPACITY 4096
+// Ids that collide longer than this are dropped instead of scanning the table
+#define ID_STATS_MAX_PROBES 32
+// Weight of a new sample in period and jitter averages is 1/2^shift
+#define ID_STATS_EWMA_SHIFT 4
+
+typedef struct id_stats_entry_t {
+  // Entry is valid only when generation matches the table
+  uint32_t generation;
+  // CAN id including CANDLE_ID_EXTENDED and CANDLE_ID_RTR flags
+  uint32_t can_id;
+
+  uint64_t count;
+  uint32_t last_timestamp_us;
+  uint32_t min_interval_us;
+  uint32_t max_interval_us;
+  double period_us;
+  // Mean absolute deviation of interval from period
+  double jitter_us;
+} id_stats_entry_t;
+
+// Open addressing hash table updated by the RX thread only. Reset bumps the
+// generation instead of clearing entries, so it never races with the writer
+typedef struct id_stats_t {
+  volatile uint32_t generation;
+  size_t capacity;
+  size_t mask;
+  // Frames of ids that did not fit into the table
+  volatile uint64_t dropped;
+  id_stats_entry_t* entries;
+} id_stats_t;
+
+// Capacity is rounded up to a power of two
+size_t id_stats_table_size(size_t capacity);
+id_stats_t* id_stats_create(size_t capacity);
+void id_stats_delete(id_stats_t* stats);
+
+void id_stats_update(id_stats_t* stats, uint32_t can_id, uint32_t timestamp_us);
+void id_stats_reset(id_stats_t* stats);
+
+static inline bool id_stats_entry_valid(const id_stats_t* stats, const id_stats_entry_t* entry)
+{
+  return entry->generation == stats->generation;
+}
+
+#endif
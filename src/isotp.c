@@ -0,0 +1,293 @@
+#include "isotp.h"
+#include "timing.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Protocol control information (upper nibble of first byte)
+enum {
+  ISOTP_PCI_SF = 0x0,
+  ISOTP_PCI_FF = 0x1,
+  ISOTP_PCI_CF = 0x2,
+  ISOTP_PCI_FC = 0x3,
+};
+
+// Flow status
+enum {
+  ISOTP_FS_CTS = 0x0,
+  ISOTP_FS_WAIT = 0x1,
+  ISOTP_FS_OVFLW = 0x2,
+};
+
+isotp_link_t* isotp_link_create(candle_handle handle, uint8_t ch, uint32_t tx_id, uint32_t rx_id,
+  uint8_t block_size, uint32_t stmin_us, int padding)
+{
+  isotp_link_t* link = malloc(sizeof(isotp_link_t));
+  if (!link)
+    return NULL;
+
+  link->handle = handle;
+  link->ch = ch;
+  link->tx_id = tx_id;
+  link->rx_id = rx_id;
+  link->block_size = block_size;
+  link->stmin = isotp_stmin_encode(stmin_us);
+  link->padding = padding >= 0;
+  link->padding_byte = (uint8_t)padding;
+
+  link->rx_active = false;
+  link->rx_fifo = fifo_create(sizeof(isotp_message_t), ISOTP_RX_QUEUE_SIZE);
+
+  link->fc_event = CreateEvent(NULL, false, false, NULL);
+  link->fc_status = ISOTP_FS_CTS;
+  InitializeSRWLock(&link->tx_lock);
+  link->stats = NULL;
+
+  return link;
+}
+
+void isotp_link_delete(isotp_link_t* link)
+{
+  if (!link)
+    return;
+
+  fifo_delete(link->rx_fifo);
+  CloseHandle(link->fc_event);
+  free(link);
+}
+
+uint8_t isotp_stmin_encode(uint32_t stmin_us)
+{
+  // 0xF1-0xF9 encode 100-900us
+  if (stmin_us && stmin_us < 1000)
+    return 0xF0 + (uint8_t)(stmin_us < 100 ? 1 : stmin_us/100);
+
+  // 0x00-0x7F encode 0-127ms
+  if (stmin_us > 127000)
+    return 0x7F;
+
+  return (uint8_t)(stmin_us/1000);
+}
+
+uint32_t isotp_stmin_decode(uint8_t stmin)
+{
+  if (stmin <= 0x7F)
+    return stmin*1000;
+
+  if (stmin >= 0xF1 && stmin <= 0xF9)
+    return (stmin - 0xF0)*100;
+
+  // Reserved values shall be interpreted as 127ms
+  return 127000;
+}
+
+static bool isotp_send_frame(isotp_link_t* link, uint32_t can_id, uint8_t* data, uint8_t len)
+{
+  candle_frame_t frame;
+
+  frame.can_id = can_id;
+  frame.flags = 0;
+  memcpy(frame.data, data, len);
+
+  if (link->padding) {
+    memset(frame.data + len, link->padding_byte, 8 - len);
+    len = 8;
+  }
+
+  frame.can_dlc = len;
+
+  bool res = candle_frame_send(link->handle, link->ch, &frame);
+  if (link->stats)
+    stats_count_tx(link->stats, len, res);
+
+  return res;
+}
+
+static void isotp_send_fc(isotp_link_t* link, uint8_t status)
+{
+  uint8_t data[3] = {(ISOTP_PCI_FC << 4) | status, link->block_size, link->stmin};
+  isotp_send_frame(link, link->tx_id, data, sizeof(data));
+}
+
+void isotp_on_frame(isotp_link_t* link, candle_frame_t* frame)
+{
+  uint8_t* data = frame->data;
+  uint8_t dlc = candle_frame_size(frame);
+  isotp_message_t* msg = &link->rx_msg;
+
+  // Only classic CAN addressing is supported
+  if (!dlc || candle_frame_is_fd(frame))
+    return;
+
+  switch (data[0] >> 4) {
+    case ISOTP_PCI_SF: {
+      uint8_t size = data[0] & 0x0F;
+      if (!size || size > dlc - 1)
+        return;
+
+      // Single frame also aborts any reception in progress
+      link->rx_active = false;
+      msg->size = size;
+      memcpy(msg->data, data + 1, size);
+      fifo_add_force(link->rx_fifo, msg);
+      break;
+    }
+
+    case ISOTP_PCI_FF: {
+      if (dlc < 8)
+        return;
+
+      uint32_t size = ((data[0] & 0x0F) << 8) | data[1];
+      if (size < 8)
+        return;
+
+      msg->size = size;
+      memcpy(msg->data, data + 2, 6);
+      link->rx_active = true;
+      link->rx_offset = 6;
+      link->rx_sn = 1;
+      link->rx_block_count = 0;
+      link->rx_last_timestamp_us = frame->timestamp_us;
+
+      isotp_send_fc(link, ISOTP_FS_CTS);
+      break;
+    }
+
+    case ISOTP_PCI_CF: {
+      if (!link->rx_active)
+        return;
+
+      // Abort on sequence error or N_Cr timeout
+      if ((data[0] & 0x0F) != link->rx_sn ||
+        frame->timestamp_us - link->rx_last_timestamp_us > ISOTP_CF_TIMEOUT_US) {
+        link->rx_active = false;
+        return;
+      }
+
+      uint32_t offset = link->rx_offset;
+      uint32_t len = msg->size - offset;
+      if (len > 7)
+        len = 7;
+      if (len > (uint32_t)dlc - 1) {
+        link->rx_active = false;
+        return;
+      }
+
+      memcpy(msg->data + offset, data + 1, len);
+      link->rx_offset += len;
+      link->rx_sn = (link->rx_sn + 1) & 0x0F;
+      link->rx_last_timestamp_us = frame->timestamp_us;
+
+      if (offset + len >= msg->size) {
+        link->rx_active = false;
+        fifo_add_force(link->rx_fifo, msg);
+      } else if (link->block_size && ++link->rx_block_count >= link->block_size) {
+        link->rx_block_count = 0;
+        isotp_send_fc(link, ISOTP_FS_CTS);
+      }
+      break;
+    }
+
+    case ISOTP_PCI_FC:
+      if (dlc < 3)
+        return;
+
+      link->fc_status = data[0] & 0x0F;
+      link->fc_block_size = data[1];
+      link->fc_stmin = data[2];
+      SetEvent(link->fc_event);
+      break;
+  }
+}
+
+// Waits for clear to send flow control, skipping WAIT frames
+static isotp_result_t isotp_wait_fc(isotp_link_t* link)
+{
+  while (true) {
+    if (WaitForSingleObject(link->fc_event, ISOTP_FC_TIMEOUT) != WAIT_OBJECT_0)
+      return ISOTP_ERR_TIMEOUT;
+
+    if (link->fc_status == ISOTP_FS_CTS)
+      return ISOTP_OK;
+
+    if (link->fc_status != ISOTP_FS_WAIT)
+      return ISOTP_ERR_OVERFLOW;
+  }
+}
+
+static isotp_result_t isotp_send_locked(isotp_link_t* link, const uint8_t* data, size_t size)
+{
+  uint8_t buf[8];
+
+  if (!size || size > ISOTP_MAX_MESSAGE_SIZE)
+    return ISOTP_ERR_SIZE;
+
+  // Single frame
+  if (size <= 7) {
+    buf[0] = (ISOTP_PCI_SF << 4) | (uint8_t)size;
+    memcpy(buf + 1, data, size);
+    return isotp_send_frame(link, link->tx_id, buf, (uint8_t)size + 1) ? ISOTP_OK : ISOTP_ERR_SEND;
+  }
+
+  // First frame. Event is reset before sending so that flow control
+  // arriving before isotp_wait_fc is not lost
+  buf[0] = (ISOTP_PCI_FF << 4) | (uint8_t)(size >> 8);
+  buf[1] = (uint8_t)size;
+  memcpy(buf + 2, data, 6);
+
+  ResetEvent(link->fc_event);
+  if (!isotp_send_frame(link, link->tx_id, buf, 8))
+    return ISOTP_ERR_SEND;
+
+  size_t offset = 6;
+  uint8_t sn = 1;
+
+  while (offset < size) {
+    isotp_result_t res = isotp_wait_fc(link);
+    if (res != ISOTP_OK)
+      return res;
+
+    uint8_t block_size = link->fc_block_size;
+    uint32_t stmin_us = isotp_stmin_decode(link->fc_stmin);
+    uint64_t next_us = 0;
+
+    // Consecutive frames until end of block or message
+    for (uint8_t i = 0; offset < size && (!block_size || i < block_size); ++i) {
+      size_t len = size - offset;
+      if (len > 7)
+        len = 7;
+
+      buf[0] = (ISOTP_PCI_CF << 4) | sn;
+      memcpy(buf + 1, data + offset, len);
+
+      if (next_us)
+        timing_sleep_until_us(next_us);
+
+      // Peer answers last frame of the block with flow control
+      if (block_size && i == block_size - 1)
+        ResetEvent(link->fc_event);
+
+      if (!isotp_send_frame(link, link->tx_id, buf, (uint8_t)len + 1))
+        return ISOTP_ERR_SEND;
+
+      next_us = timing_now_us() + stmin_us;
+      offset += len;
+      sn = (sn + 1) & 0x0F;
+    }
+  }
+
+  return ISOTP_OK;
+}
+
+isotp_result_t isotp_send(isotp_link_t* link, const uint8_t* data, size_t size)
+{
+  AcquireSRWLockExclusive(&link->tx_lock);
+  isotp_result_t res = isotp_send_locked(link, data, size);
+  ReleaseSRWLockExclusive(&link->tx_lock);
+
+  return res;
+}
+
+bool isotp_recv(isotp_link_t* link, isotp_message_t* msg, uint32_t timeout)
+{
+  return fifo_get(link->rx_fifo, msg, timeout);
+}
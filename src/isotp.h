@@ -0,0 +1,86 @@
+#ifndef _ISOTP_H_
+#define _ISOTP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <windows.h>
+#include "candle_api/candle.h"
+#include "fifo.h"
+#include "stats.h"
+
+#define ISOTP_MAX_LINKS 4
+#define ISOTP_MAX_MESSAGE_SIZE 4095
+#define ISOTP_RX_QUEUE_SIZE 4
+// N_Bs and N_Cr timeouts
+#define ISOTP_FC_TIMEOUT 1000 // in ms
+#define ISOTP_CF_TIMEOUT_US 1000000
+
+typedef enum {
+  ISOTP_OK,
+  ISOTP_ERR_SIZE,
+  ISOTP_ERR_SEND,
+  ISOTP_ERR_TIMEOUT,
+  ISOTP_ERR_OVERFLOW,
+} isotp_result_t;
+
+typedef struct isotp_message_t {
+  uint32_t size;
+  uint8_t data[ISOTP_MAX_MESSAGE_SIZE];
+} isotp_message_t;
+
+// Single address pair (tx_id, rx_id) on a channel
+typedef struct isotp_link_t {
+  candle_handle handle;
+  uint8_t ch;
+
+  // CAN ids including CANDLE_ID_EXTENDED flag
+  uint32_t tx_id;
+  uint32_t rx_id;
+
+  // Flow control parameters sent to the peer
+  uint8_t block_size;
+  uint8_t stmin;
+
+  // Pad frames to 8 bytes when padding is enabled
+  bool padding;
+  uint8_t padding_byte;
+
+  // Reception state (only accessed by the RX thread)
+  isotp_message_t rx_msg;
+  bool rx_active;
+  uint32_t rx_offset;
+  uint8_t rx_sn;
+  uint8_t rx_block_count;
+  uint32_t rx_last_timestamp_us;
+
+  // Completed messages
+  fifo_t* rx_fifo;
+
+  // Last flow control frame received from the peer
+  HANDLE fc_event;
+  volatile uint8_t fc_status;
+  volatile uint8_t fc_block_size;
+  volatile uint8_t fc_stmin;
+
+  // Serializes transmissions
+  SRWLOCK tx_lock;
+
+  // Optional channel counters updated on transmission
+  candle_channel_stats_t* stats;
+} isotp_link_t;
+
+isotp_link_t* isotp_link_create(candle_handle handle, uint8_t ch, uint32_t tx_id, uint32_t rx_id,
+  uint8_t block_size, uint32_t stmin_us, int padding);
+void isotp_link_delete(isotp_link_t* link);
+
+// Called by the RX thread for every frame with rx_id
+void isotp_on_frame(isotp_link_t* link, candle_frame_t* frame);
+
+// Blocks until whole message is sent
+isotp_result_t isotp_send(isotp_link_t* link, const uint8_t* data, size_t size);
+bool isotp_recv(isotp_link_t* link, isotp_message_t* msg, uint32_t timeout);
+
+uint8_t isotp_stmin_encode(uint32_t stmin_us);
+uint32_t isotp_stmin_decode(uint8_t stmin);
+
+#endif
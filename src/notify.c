@@ -0,0 +1,113 @@
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include "notify.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct notify_t {
+  SOCKET rd;
+  SOCKET wr;
+  // Set while a byte is in flight so signals do not fill the socket buffer
+  volatile LONG pending;
+};
+
+// Emulates socketpair() by connecting two sockets over loopback
+static bool notify_socketpair(SOCKET* rd, SOCKET* wr)
+{
+  struct sockaddr_in addr;
+  int addr_len = sizeof(addr);
+  SOCKET listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+  *rd = INVALID_SOCKET;
+  *wr = INVALID_SOCKET;
+
+  if (listener == INVALID_SOCKET)
+    return false;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+
+  if (!bind(listener, (struct sockaddr*)&addr, sizeof(addr)) &&
+      !getsockname(listener, (struct sockaddr*)&addr, &addr_len) &&
+      !listen(listener, 1)) {
+    *wr = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (*wr != INVALID_SOCKET && !connect(*wr, (struct sockaddr*)&addr, sizeof(addr)))
+      *rd = accept(listener, NULL, NULL);
+  }
+
+  closesocket(listener);
+
+  if (*rd == INVALID_SOCKET) {
+    if (*wr != INVALID_SOCKET)
+      closesocket(*wr);
+    *wr = INVALID_SOCKET;
+    return false;
+  }
+
+  return true;
+}
+
+notify_t* notify_create(void)
+{
+  WSADATA wsa;
+  u_long non_blocking = 1;
+  BOOL no_delay = TRUE;
+
+  if (WSAStartup(MAKEWORD(2, 2), &wsa))
+    return NULL;
+
+  notify_t* notify = malloc(sizeof(notify_t));
+  if (!notify || !notify_socketpair(&notify->rd, &notify->wr)) {
+    free(notify);
+    WSACleanup();
+    return NULL;
+  }
+
+  notify->pending = 0;
+
+  // Signal must never block the RX thread and must not be delayed by Nagle
+  ioctlsocket(notify->rd, FIONBIO, &non_blocking);
+  ioctlsocket(notify->wr, FIONBIO, &non_blocking);
+  setsockopt(notify->wr, IPPROTO_TCP, TCP_NODELAY, (const char*)&no_delay, sizeof(no_delay));
+
+  return notify;
+}
+
+void notify_delete(notify_t* notify)
+{
+  if (!notify)
+    return;
+
+  closesocket(notify->rd);
+  closesocket(notify->wr);
+  free(notify);
+
+  WSACleanup();
+}
+
+void notify_signal(notify_t* notify)
+{
+  char byte = 1;
+
+  if (!InterlockedExchange(&notify->pending, 1))
+    send(notify->wr, &byte, 1, 0);
+}
+
+void notify_clear(notify_t* notify)
+{
+  char buf[16];
+
+  // Drain before clearing pending, otherwise a signal in between would be
+  // swallowed and pending would stay set forever
+  while (recv(notify->rd, buf, sizeof(buf), 0) > 0);
+
+  InterlockedExchange(&notify->pending, 0);
+}
+
+intptr_t notify_fileno(notify_t* notify)
+{
+  return (intptr_t)notify->rd;
+}
@@ -0,0 +1,23 @@
+#ifndef _NOTIFY_H_
+#define _NOTIFY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Pollable readiness signal: connected loopback socket pair (windows has no
+// eventfd/pipe that select() accepts). Reader end can be registered with
+// selectors and asyncio loop.add_reader
+typedef struct notify_t notify_t;
+
+notify_t* notify_create(void);
+void notify_delete(notify_t* notify);
+
+// Makes reader end readable, cheap when already signalled
+void notify_signal(notify_t* notify);
+// Consumes pending signal, must be called before checking the data source
+void notify_clear(notify_t* notify);
+
+// Socket handle of the reader end
+intptr_t notify_fileno(notify_t* notify);
+
+#endif
@@ -1,6 +1,11 @@
 #include "py_candle_channel.h"
 #include "py_candle_device.h"
+#include "py_candle_dbc.h"
+#include "py_candle_frame.h"
+#include "py_candle_subscription.h"
 #include "fifo.h"
+#include "timing.h"
+#include <string.h>
 
 void py_candle_channel_dealloc(py_candle_channel* self)
 {
@@ -10,11 +15,57 @@ void py_candle_channel_dealloc(py_candle_channel* self)
   // Unlink channel from interface
   py_candle_device_close_channel(self->_device, self->_ch);
 
+  // RX thread no longer sees the channel. Drop queued frames, stop
+  // forwarding and release destinations of the routes
+  txq_delete(self->_txq);
+
+  // Cancelled handles included. None is awaited, the event loop reader would
+  // keep the channel alive
+  while (self->_send_done) {
+    py_candle_send_handle* handle = self->_send_done;
+    self->_send_done = handle->_next;
+    handle->_channel = NULL;
+    Py_DECREF(handle);
+  }
+  notify_delete(self->_send_notify);
+
+  if (self->_gateway) {
+    gateway_route_t routes[GATEWAY_MAX_ROUTES];
+    size_t count = gateway_routes(self->_gateway, routes, GATEWAY_MAX_ROUTES, false);
+
+    Py_BEGIN_ALLOW_THREADS
+    gateway_delete(self->_gateway);
+    Py_END_ALLOW_THREADS
+
+    for (size_t i = 0; i < count; ++i)
+      Py_DECREF((PyObject*)routes[i].dst_ctx);
+  }
+
   // Release interface
   Py_DECREF(self->_device);
 
   // Remove fifo
   fifo_delete(self->_fifo);
+  fifo_delete(self->_prio_fifo);
+  notify_delete(self->_notify);
+  broadcast_delete(self->_broadcast);
+
+  // Dispatcher thread is gone, it holds a reference while running
+  if (self->_dispatch) {
+    for (size_t i = 0; i < self->_dispatch->route_count; ++i)
+      Py_DECREF((PyObject*)self->_dispatch->routes[i].ctx);
+    PyMem_RawFree(self->_dispatch);
+  }
+  Py_XDECREF(self->_async_loop);
+  Py_XDECREF(self->_async_future);
+
+  CloseHandle(self->_echo_event);
+
+  for (uint8_t i = 0; i < self->_isotp_link_count; ++i)
+    isotp_link_delete(self->_isotp_links[i]);
+
+  uavcan_delete(self->_uavcan);
+  id_stats_delete(self->_id_stats);
 
   // Free self
   Py_TYPE(self)->tp_free((PyObject*)self);
@@ -35,6 +86,61 @@ PyObject* py_candle_channel_new(PyTypeObject *type, PyObject *args, PyObject *kw
 
   // Initialize RX FIFO
   self->_fifo = fifo_create(sizeof(candle_frame_t), CANDLE_RX_FIFO_SIZE);
+  self->_prio_fifo = fifo_create(sizeof(candle_frame_t), CANDLE_PRIORITY_FIFO_SIZE);
+  self->_prio_enabled = false;
+  memset(self->_prio_std, 0, sizeof(self->_prio_std));
+  self->_prio_ext_count = 0;
+  self->_prio_overwrite_base = 0;
+
+  // Initialize timed transmission
+  InitializeSRWLock(&self->_write_at_lock);
+  self->_echo_event = CreateEvent(NULL, false, false, NULL);
+  self->_echo_wait_id = 0;
+  self->_echo_seq = 0;
+  self->_tx_latency_us = CANDLE_TX_LATENCY_INIT_US;
+
+  self->_isotp_link_count = 0;
+  self->_uavcan = NULL;
+
+  memset(&self->_error_stats, 0, sizeof(self->_error_stats));
+  memset(&self->_error_base, 0, sizeof(self->_error_base));
+  memset(&self->_stats, 0, sizeof(self->_stats));
+  memset(&self->_stats_base, 0, sizeof(self->_stats_base));
+  self->_fifo_overwrite_base = 0;
+  self->_latency_enabled = false;
+  self->_bitrate = 0;
+  self->_data_bitrate = 0;
+  self->_id_stats = NULL;
+  self->_id_stats_enabled = false;
+
+  self->_iter_pos = 0;
+  self->_iter_count = 0;
+  self->_iter_batch = CANDLE_RX_FIFO_SIZE;
+  self->_iter_timeout_ms = INFINITE;
+  self->_iter_stop_on_timeout = true;
+  self->_iter_busy = false;
+
+  self->_notify = NULL;
+  self->_async_loop = NULL;
+  self->_async_future = NULL;
+
+  self->_broadcast = NULL;
+
+  self->_dispatch = NULL;
+  self->_dispatch_thread = NULL;
+  self->_dispatch_thread_id = 0;
+  self->_dispatch_stop = false;
+  self->_dispatch_next = NULL;
+  self->_dispatch_batches = 0;
+  self->_dispatch_unhandled = 0;
+
+  self->_txq = NULL;
+  InitializeSRWLock(&self->_send_lock);
+  self->_send_done = NULL;
+  self->_send_notify = NULL;
+  self->_send_loop = NULL;
+  self->_send_waiters = 0;
+  self->_gateway = NULL;
 
   // Prevent device from deallocation
   Py_INCREF(self->_device);
@@ -81,10 +187,24 @@ PyObject* py_candle_channel_set_bitrate(py_candle_channel* self, PyObject* args)
   
   if (!candle_channel_set_bitrate(self->_handle, self->_ch, bitrate))
     return Py_BuildValue("O", Py_False);
-  
+
+  self->_bitrate = bitrate;
+
   return Py_BuildValue("O", Py_True);
 }
 
+// Bitrate resulting from bit timing, 0 if device clock is unknown
+static uint32_t py_candle_channel_timing_bitrate(py_candle_channel* self, candle_bittiming_t* timing)
+{
+  candle_capability_t cap;
+  uint32_t tq = timing->brp * (1 + timing->prop_seg + timing->phase_seg1 + timing->phase_seg2);
+
+  if (!tq || !candle_channel_get_capabilities(self->_handle, self->_ch, &cap))
+    return 0;
+
+  return cap.fclk_can / tq;
+}
+
 PyObject* py_candle_channel_set_timings(py_candle_channel* self, PyObject* args, PyObject* kwds)
 {
   candle_bittiming_t timing;
@@ -98,36 +218,355 @@ PyObject* py_candle_channel_set_timings(py_candle_channel* self, PyObject* args,
   if (!candle_channel_set_timing(self->_handle, self->_ch, &timing))
     return Py_BuildValue("O", Py_False);
 
+  self->_bitrate = py_candle_channel_timing_bitrate(self, &timing);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+PyObject* py_candle_channel_set_data_bitrate(py_candle_channel* self, PyObject* args)
+{
+  uint32_t bitrate;
+
+  if (!PyArg_ParseTuple(args, "k", &bitrate))
+    return Py_BuildValue("O", Py_False);
+
+  if (!candle_channel_set_data_bitrate(self->_handle, self->_ch, bitrate))
+    return Py_BuildValue("O", Py_False);
+
+  self->_data_bitrate = bitrate;
+
+  return Py_BuildValue("O", Py_True);
+}
+
+PyObject* py_candle_channel_set_data_timings(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  candle_bittiming_t timing;
+
+  static char* kwlist[] = {"prop_seg", "phase_seg1", "phase_seg2", "sjw", "brp", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "kkkkk", kwlist,
+    &timing.prop_seg, &timing.phase_seg1, &timing.phase_seg2, &timing.sjw, &timing.brp))
+    return Py_BuildValue("O", Py_False);
+
+  if (!candle_channel_set_data_timing(self->_handle, self->_ch, &timing))
+    return Py_BuildValue("O", Py_False);
+
+  self->_data_bitrate = py_candle_channel_timing_bitrate(self, &timing);
+
   return Py_BuildValue("O", Py_True);
 }
 
+// Fills frame payload. Data longer than 8 bytes is sent as CAN FD frame
+// and padded with zeros to the next valid FD length
+bool py_candle_channel_fill_frame(candle_frame_t* frame, uint32_t can_id, const uint8_t* buf, Py_ssize_t len, uint32_t flags)
+{
+  if (len > (Py_ssize_t)sizeof(frame->data)) {
+    PyErr_Format(PyExc_ValueError, "Data length %zd exceeds %zu bytes.", len, sizeof(frame->data));
+    return false;
+  }
+
+  if (len > 8)
+    flags |= CANDLE_FLAG_FD;
+
+  frame->can_id = can_id;
+  frame->flags = (uint8_t)flags;
+  frame->reserved = 0;
+  memcpy(frame->data, buf, len);
+
+  if (flags & CANDLE_FLAG_FD) {
+    frame->can_dlc = candle_dlc_from_size((uint8_t)len);
+    memset(frame->data + len, 0, candle_frame_size(frame) - len);
+  } else {
+    frame->can_dlc = (uint8_t)len;
+  }
+
+  return true;
+}
+
 PyObject* py_candle_channel_write(py_candle_channel* self, PyObject* args)
 {
   candle_frame_t frame;
+  uint32_t can_id;
+  uint32_t flags = 0;
   const uint8_t* buf;
   Py_ssize_t len;
   bool res;
 
-  if (!PyArg_ParseTuple(args, "ky#", &frame.can_id, &buf, &len))
+  if (!PyArg_ParseTuple(args, "ky#|k", &can_id, &buf, &len, &flags))
     return Py_BuildValue("O", Py_False);
 
-  if (len > 8)
-    return PyErr_Format(PyExc_ValueError, "Data length %u exceeds 8 bytes.", len);
-
-  memcpy(frame.data, buf, len);
-  frame.can_dlc = (uint8_t)len;
+  if (!py_candle_channel_fill_frame(&frame, can_id, buf, len, flags))
+    return NULL;
 
   Py_BEGIN_ALLOW_THREADS
   res = candle_frame_send(self->_handle, self->_ch, &frame);
   Py_END_ALLOW_THREADS
 
+  stats_count_tx(&self->_stats, candle_frame_size(&frame), res);
+
   if (!res)
     return Py_BuildValue("O", Py_False);
 
   return Py_BuildValue("O", Py_True);
 }
 
-PyObject* py_candle_channel_read(py_candle_channel* self, PyObject* args)
+// Sends frame so that it hits the bus at time t. Time is either host time
+// (candle_driver.host_timestamp()) or device time (device.timestamp()).
+// Returns (echo_timestamp, target_timestamp, error) in device time (us)
+PyObject* py_candle_channel_write_at(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  candle_frame_t frame;
+  uint32_t can_id;
+  uint32_t flags = 0;
+  const uint8_t* buf;
+  Py_ssize_t len;
+  unsigned long long t;
+  int device_time = 0;
+  uint32_t target_us;
+  uint64_t deadline_us;
+  DWORD wait_result = WAIT_FAILED;
+  bool res;
+
+  static char* kwlist[] = {"can_id", "data", "t", "device_time", "flags", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "ky#K|pk", kwlist, &can_id, &buf, &len, &t, &device_time, &flags))
+    return NULL;
+
+  if (!py_candle_channel_fill_frame(&frame, can_id, buf, len, flags))
+    return NULL;
+
+  py_candle_device* device = self->_device;
+
+  Py_BEGIN_ALLOW_THREADS
+  // Only one timed frame per channel can wait for its echo
+  AcquireSRWLockExclusive(&self->_write_at_lock);
+
+  if (device_time) {
+    target_us = (uint32_t)t;
+    deadline_us = py_candle_device_host_time_us(device, target_us);
+  } else {
+    deadline_us = t;
+    target_us = py_candle_device_device_time_us(device, deadline_us);
+  }
+
+  uint32_t echo_id = CANDLE_ECHO_ID_TIMED + self->_echo_seq++ % CANDLE_ECHO_ID_TIMED_COUNT;
+
+  ResetEvent(self->_echo_event);
+  self->_echo_wait_id = echo_id;
+
+  // Release early by the measured USB latency
+  timing_sleep_until_us(deadline_us - self->_tx_latency_us);
+
+  uint32_t send_us = py_candle_device_device_time_us(device, timing_now_us());
+  res = candle_frame_send_echo(self->_handle, self->_ch, &frame, echo_id);
+  stats_count_tx(&self->_stats, candle_frame_size(&frame), res);
+
+  if (res)
+    wait_result = WaitForSingleObject(self->_echo_event, CANDLE_ECHO_TIMEOUT);
+
+  self->_echo_wait_id = 0;
+
+  // Update latency estimate (EWMA, alpha = 1/8)
+  if (wait_result == WAIT_OBJECT_0) {
+    int32_t latency = (int32_t)(self->_echo_timestamp_us - send_us);
+    if (latency > 0)
+      self->_tx_latency_us += (latency - self->_tx_latency_us) / 8;
+  }
+
+  ReleaseSRWLockExclusive(&self->_write_at_lock);
+  Py_END_ALLOW_THREADS
+
+  if (!res)
+    return Py_BuildValue("O", Py_False);
+
+  if (wait_result != WAIT_OBJECT_0)
+    return PyErr_Format(PyExc_TimeoutError, "CAN echo timeout.");
+
+  return Py_BuildValue("kkl",
+    self->_echo_timestamp_us,
+    target_us,
+    (long)(int32_t)(self->_echo_timestamp_us - target_us)
+  );
+}
+
+// Opens ISO-TP link for address pair and returns its index
+PyObject* py_candle_channel_isotp_open(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t tx_id, rx_id;
+  uint8_t block_size = 0;
+  uint32_t stmin_us = 0;
+  PyObject* padding = Py_None;
+
+  static char* kwlist[] = {"tx_id", "rx_id", "block_size", "stmin_us", "padding", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "kk|BkO", kwlist, &tx_id, &rx_id, &block_size, &stmin_us, &padding))
+    return NULL;
+
+  int padding_byte = -1;
+  if (padding != Py_None) {
+    padding_byte = (int)PyLong_AsLong(padding);
+    if (padding_byte < 0 || padding_byte > 0xFF)
+      return PyErr_Format(PyExc_ValueError, "Padding must be a byte value or None.");
+  }
+
+  if (self->_isotp_link_count >= ISOTP_MAX_LINKS)
+    return PyErr_Format(PyExc_ValueError, "Maximum of %u ISO-TP links reached.", ISOTP_MAX_LINKS);
+
+  isotp_link_t* link = isotp_link_create(self->_handle, self->_ch, tx_id, rx_id, block_size, stmin_us, padding_byte);
+  if (!link)
+    return PyErr_NoMemory();
+
+  link->stats = &self->_stats;
+
+  // Link is fully initialized before RX thread can see it
+  self->_isotp_links[self->_isotp_link_count] = link;
+  MemoryBarrier();
+  self->_isotp_link_count++;
+
+  return Py_BuildValue("B", self->_isotp_link_count - 1);
+}
+
+PyObject* py_candle_channel_isotp_send(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  const uint8_t* buf;
+  Py_ssize_t len;
+  uint8_t index = 0;
+  isotp_result_t res;
+
+  static char* kwlist[] = {"payload", "link", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "y#|B", kwlist, &buf, &len, &index))
+    return NULL;
+
+  if (index >= self->_isotp_link_count)
+    return PyErr_Format(PyExc_ValueError, "ISO-TP link %u is not open.", index);
+
+  Py_BEGIN_ALLOW_THREADS
+  res = isotp_send(self->_isotp_links[index], buf, len);
+  Py_END_ALLOW_THREADS
+
+  switch (res) {
+    case ISOTP_OK:
+      return Py_BuildValue("O", Py_True);
+    case ISOTP_ERR_SIZE:
+      return PyErr_Format(PyExc_ValueError, "ISO-TP payload length %zd is out of range.", len);
+    case ISOTP_ERR_TIMEOUT:
+      return PyErr_Format(PyExc_TimeoutError, "ISO-TP flow control timeout.");
+    case ISOTP_ERR_OVERFLOW:
+      return PyErr_Format(PyExc_OverflowError, "ISO-TP receiver overflow.");
+    default:
+      return Py_BuildValue("O", Py_False);
+  }
+}
+
+PyObject* py_candle_channel_isotp_recv(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  uint8_t index = 0;
+  uint32_t timeout_ms = 0;
+  bool res;
+
+  static char* kwlist[] = {"link", "timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Bk", kwlist, &index, &timeout_ms))
+    return NULL;
+
+  if (index >= self->_isotp_link_count)
+    return PyErr_Format(PyExc_ValueError, "ISO-TP link %u is not open.", index);
+
+  // Message is too large for the stack
+  isotp_message_t* msg = PyMem_RawMalloc(sizeof(isotp_message_t));
+  if (!msg)
+    return PyErr_NoMemory();
+
+  Py_BEGIN_ALLOW_THREADS
+  res = isotp_recv(self->_isotp_links[index], msg, timeout_ms);
+  Py_END_ALLOW_THREADS
+
+  PyObject* payload = res ? Py_BuildValue("y#", msg->data, (Py_ssize_t)msg->size) : NULL;
+  PyMem_RawFree(msg);
+
+  if (!res)
+    return PyErr_Format(PyExc_TimeoutError, "ISO-TP read timeout.");
+
+  return payload;
+}
+
+// Registers UAVCAN data type signature. Only registered data types are
+// reassembled, other frames are still returned by read()
+PyObject* py_candle_channel_uavcan_register(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  uint16_t data_type_id;
+  unsigned long long signature;
+  int service = 0;
+
+  static char* kwlist[] = {"data_type_id", "signature", "service", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "HK|p", kwlist, &data_type_id, &signature, &service))
+    return NULL;
+
+  if (!self->_uavcan) {
+    uavcan_t* uavcan = uavcan_create();
+    if (!uavcan)
+      return PyErr_NoMemory();
+
+    MemoryBarrier();
+    self->_uavcan = uavcan;
+  }
+
+  if (!uavcan_register(self->_uavcan, data_type_id, service, signature))
+    return PyErr_Format(PyExc_ValueError, "Maximum of %u UAVCAN data types reached.", UAVCAN_MAX_DATA_TYPES);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+PyObject* py_candle_channel_uavcan_send(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  const uint8_t* buf;
+  Py_ssize_t len;
+  bool res;
+
+  uavcan_transfer_t* transfer = PyMem_RawMalloc(sizeof(uavcan_transfer_t));
+  if (!transfer)
+    return PyErr_NoMemory();
+
+  transfer->priority = 16;
+  transfer->kind = UAVCAN_TRANSFER_MESSAGE;
+  transfer->destination_node = 0;
+
+  static char* kwlist[] = {"data_type_id", "payload", "source_node", "transfer_id", "priority", "kind", "destination_node", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "Hy#BB|BBB", kwlist, &transfer->data_type_id, &buf, &len,
+    &transfer->source_node, &transfer->transfer_id, &transfer->priority, &transfer->kind, &transfer->destination_node)) {
+    PyMem_RawFree(transfer);
+    return NULL;
+  }
+
+  if (len > UAVCAN_MAX_TRANSFER_SIZE) {
+    PyMem_RawFree(transfer);
+    return PyErr_Format(PyExc_ValueError, "UAVCAN payload length %zd exceeds %u bytes.", len, UAVCAN_MAX_TRANSFER_SIZE);
+  }
+
+  if (len > 7 && (!self->_uavcan || !uavcan_find_data_type(self->_uavcan, transfer->data_type_id, transfer->kind != UAVCAN_TRANSFER_MESSAGE))) {
+    PyMem_RawFree(transfer);
+    return PyErr_Format(PyExc_ValueError, "Multi-frame transfer requires registered data type signature.");
+  }
+
+  memcpy(transfer->payload, buf, len);
+  transfer->size = (uint16_t)len;
+
+  Py_BEGIN_ALLOW_THREADS
+  res = uavcan_send(self->_uavcan, self->_handle, self->_ch, &self->_stats, transfer);
+  Py_END_ALLOW_THREADS
+
+  PyMem_RawFree(transfer);
+
+  if (!res)
+    return Py_BuildValue("O", Py_False);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+PyObject* py_candle_channel_uavcan_recv(py_candle_channel* self, PyObject* args)
 {
   uint32_t timeout_ms = 0;
   bool res;
@@ -135,34 +574,1939 @@ PyObject* py_candle_channel_read(py_candle_channel* self, PyObject* args)
   if (!PyArg_ParseTuple(args, "|k", &timeout_ms))
     return NULL;
 
-  candle_frame_t frame;
+  if (!self->_uavcan)
+    return PyErr_Format(PyExc_ValueError, "No UAVCAN data types registered.");
+
+  uavcan_transfer_t* transfer = PyMem_RawMalloc(sizeof(uavcan_transfer_t));
+  if (!transfer)
+    return PyErr_NoMemory();
 
   Py_BEGIN_ALLOW_THREADS
-  // Read from FIFO which is filled by the RX thread in py_candle_device
-  res = fifo_get(self->_fifo, &frame, timeout_ms);
+  res = fifo_get(self->_uavcan->rx_fifo, transfer, timeout_ms);
   Py_END_ALLOW_THREADS
 
+  PyObject* result = NULL;
+  if (res) {
+    result = Py_BuildValue("BHBBBBy#k",
+      transfer->kind,
+      transfer->data_type_id,
+      transfer->source_node,
+      transfer->destination_node,
+      transfer->transfer_id,
+      transfer->priority,
+      transfer->payload,
+      (Py_ssize_t)transfer->size,
+      transfer->timestamp_us
+    );
+  }
+
+  PyMem_RawFree(transfer);
+
   if (!res)
+    return PyErr_Format(PyExc_TimeoutError, "UAVCAN read timeout.");
+
+  return result;
+}
+
+// Drains up to max_frames from the RX FIFO and decodes them with DBC database
+PyObject* py_candle_channel_decode(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  py_candle_dbc* dbc;
+  uint32_t max_frames = CANDLE_RX_FIFO_SIZE;
+  uint32_t timeout_ms = 0;
+  size_t count;
+
+  static char* kwlist[] = {"dbc", "max_frames", "timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!|kk", kwlist, &py_candle_dbc_type, &dbc, &max_frames, &timeout_ms))
+    return NULL;
+
+  candle_frame_t* frames = PyMem_RawMalloc(max_frames*sizeof(candle_frame_t));
+  if (!frames)
+    return PyErr_NoMemory();
+
+  Py_BEGIN_ALLOW_THREADS
+  count = fifo_get_many(self->_fifo, frames, max_frames, timeout_ms);
+  Py_END_ALLOW_THREADS
+
+  if (!count) {
+    PyMem_RawFree(frames);
     return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+  }
+
+  PyObject* result = py_candle_dbc_decode_frames(dbc, frames, count);
+  PyMem_RawFree(frames);
+
+  return result;
+}
+
+PyObject* py_candle_channel_set_berr_reporting(py_candle_channel* self, PyObject* args)
+{
+  int enable;
+
+  if (!PyArg_ParseTuple(args, "p", &enable))
+    return NULL;
+
+  if (!candle_channel_set_berr_reporting(self->_handle, self->_ch, enable))
+    return Py_BuildValue("O", Py_False);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+// Returns error frame counters and bus state, optionally resetting counters
+PyObject* py_candle_channel_error_stats(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  int reset = 0;
+
+  static char* kwlist[] = {"reset", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+    return NULL;
 
-  return Py_BuildValue("kky#Ok",
-    candle_frame_type(&frame),
-    candle_frame_id(&frame),
-    frame.data,
-    (Py_ssize_t)frame.can_dlc,
-    candle_frame_is_extended_id(&frame) ? Py_True : Py_False,
-    candle_frame_timestamp_us(&frame)
+  can_error_stats_t* s = &self->_error_stats;
+  can_error_counters_t counters;
+
+  // Counters are only written by the RX thread, reset stores a baseline
+  // instead of clearing them under it
+  stats_snapshot(&s->counters.error_frames, &self->_error_base.error_frames, (int64_t*)&counters,
+    STATS_COUNTER_COUNT(can_error_counters_t));
+  if (reset)
+    stats_reset(&s->counters.error_frames, &self->_error_base.error_frames, STATS_COUNTER_COUNT(can_error_counters_t));
+
+  return Py_BuildValue("{s:B,s:B,s:B,s:k,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L}",
+    "state", s->state,
+    "tx_errors", s->tx_errors,
+    "rx_errors", s->rx_errors,
+    "last_timestamp", s->last_timestamp_us,
+    "error_frames", counters.error_frames,
+    "warning", counters.warning_count,
+    "passive", counters.passive_count,
+    "bus_off", counters.bus_off_count,
+    "restarted", counters.restart_count,
+    "arbitration_lost", counters.arbitration_lost,
+    "bit_errors", counters.bit_errors,
+    "stuff_errors", counters.stuff_errors,
+    "form_errors", counters.form_errors,
+    "ack_errors", counters.ack_errors,
+    "crc_errors", counters.crc_errors,
+    "tx_timeouts", counters.tx_timeouts,
+    "transceiver_errors", counters.transceiver_errors,
+    "rx_overflows", counters.rx_overflows,
+    "tx_overflows", counters.tx_overflows
+  );
+}
+
+double py_candle_channel_bus_load(py_candle_channel* self, uint32_t window_ms)
+{
+  return bus_load_get(&self->_bus_load, timing_now_us(), window_ms, self->_bitrate, self->_data_bitrate);
+}
+
+// Returns bus load of given window or of 10ms, 100ms and 1s windows
+PyObject* py_candle_channel_bus_load_py(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t window_ms = 0;
+
+  static char* kwlist[] = {"window_ms", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|k", kwlist, &window_ms))
+    return NULL;
+
+  if (!self->_bitrate)
+    return PyErr_Format(PyExc_RuntimeError, "Bitrate is unknown, set it with set_bitrate() or set_timings().");
+
+  if (window_ms > BUS_LOAD_MAX_WINDOW_MS)
+    return PyErr_Format(PyExc_ValueError, "Window must not exceed %u ms.", BUS_LOAD_MAX_WINDOW_MS);
+
+  if (window_ms)
+    return Py_BuildValue("d", py_candle_channel_bus_load(self, window_ms));
+
+  return Py_BuildValue("{s:d,s:d,s:d}",
+    "10ms", py_candle_channel_bus_load(self, 10),
+    "100ms", py_candle_channel_bus_load(self, 100),
+    "1s", py_candle_channel_bus_load(self, 1000)
   );
 }
 
+// Enables per-id period and jitter statistics. A capacity other than the
+// current table size replaces the table and drops collected statistics
+PyObject* py_candle_channel_set_id_stats(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  int enable = 1;
+  PyObject* capacity_arg = Py_None;
+  Py_ssize_t capacity = ID_STATS_DEFAULT_CAPACITY;
+
+  static char* kwlist[] = {"enable", "capacity", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|pO", kwlist, &enable, &capacity_arg))
+    return NULL;
+
+  if (capacity_arg != Py_None) {
+    capacity = PyLong_AsSsize_t(capacity_arg);
+    if (capacity == -1 && PyErr_Occurred())
+      return NULL;
+  }
+
+  if (capacity <= 0)
+    return PyErr_Format(PyExc_ValueError, "Capacity must be positive.");
+
+  bool resize = self->_id_stats && capacity_arg != Py_None &&
+    id_stats_table_size(capacity) != self->_id_stats->capacity;
+
+  if (enable && (!self->_id_stats || resize)) {
+    id_stats_t* stats = id_stats_create(capacity);
+    if (!stats)
+      return PyErr_NoMemory();
+
+    // RX thread uses the table under the shared lock
+    AcquireSRWLockExclusive(&self->_device->_channels_lock);
+    id_stats_t* old = self->_id_stats;
+    self->_id_stats = stats;
+    ReleaseSRWLockExclusive(&self->_device->_channels_lock);
+
+    id_stats_delete(old);
+  } else if (enable && !self->_id_stats_enabled) {
+    id_stats_reset(self->_id_stats);
+  }
+
+  self->_id_stats_enabled = enable;
+
+  Py_RETURN_NONE;
+}
+
+// Returns {can_id: {count, last_timestamp, period, jitter, min, max}}, times in us
+PyObject* py_candle_channel_id_stats(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  int reset = 0;
+
+  static char* kwlist[] = {"reset", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+    return NULL;
+
+  PyObject* res = PyDict_New();
+  id_stats_t* stats = self->_id_stats;
+
+  if (!res || !stats)
+    return res;
+
+  for (size_t i = 0; i < stats->capacity; ++i) {
+    // Copy so values of one id are consistent with each other
+    id_stats_entry_t entry = stats->entries[i];
+
+    if (!id_stats_entry_valid(stats, &entry))
+      continue;
+
+    bool has_interval = entry.count > 1;
+    PyObject* key = PyLong_FromUnsignedLong(entry.can_id);
+    PyObject* value = Py_BuildValue("{s:K,s:k,s:d,s:d,s:k,s:k}",
+      "count", entry.count,
+      "last_timestamp", entry.last_timestamp_us,
+      "period", entry.period_us,
+      "jitter", entry.jitter_us,
+      "min", has_interval ? entry.min_interval_us : 0,
+      "max", entry.max_interval_us
+    );
+
+    if (!key || !value || PyDict_SetItem(res, key, value)) {
+      Py_XDECREF(key);
+      Py_XDECREF(value);
+      Py_DECREF(res);
+      return NULL;
+    }
+
+    Py_DECREF(key);
+    Py_DECREF(value);
+  }
+
+  if (reset)
+    id_stats_reset(stats);
+
+  return res;
+}
+
+// Enables recording of delivery latency histograms
+PyObject* py_candle_channel_set_latency_tracking(py_candle_channel* self, PyObject* args)
+{
+  int enable = 1;
+
+  if (!PyArg_ParseTuple(args, "|p", &enable))
+    return NULL;
+
+  if (enable && !self->_latency_enabled) {
+    histogram_reset(&self->_latency_hw_to_urb);
+    histogram_reset(&self->_latency_urb_to_fifo);
+    histogram_reset(&self->_latency_urb_to_read);
+  }
+
+  self->_latency_enabled = enable;
+
+  Py_RETURN_NONE;
+}
+
+static PyObject* py_candle_channel_histogram_dict(histogram_t* hist)
+{
+  // Copy so percentiles are computed from a consistent set of buckets
+  histogram_t* copy = PyMem_RawMalloc(sizeof(histogram_t));
+  if (!copy)
+    return PyErr_NoMemory();
+
+  memcpy(copy, (void*)hist, sizeof(histogram_t));
+
+  PyObject* res = Py_BuildValue("{s:K,s:K,s:K,s:K,s:K}",
+    "count", copy->count,
+    "p50", histogram_percentile(copy, 50.0),
+    "p99", histogram_percentile(copy, 99.0),
+    "p99_9", histogram_percentile(copy, 99.9),
+    "max", copy->max
+  );
+
+  PyMem_RawFree(copy);
+
+  return res;
+}
+
+// Returns latency percentiles in us for each pipeline stage
+PyObject* py_candle_channel_latency_stats(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  int reset = 0;
+
+  static char* kwlist[] = {"reset", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+    return NULL;
+
+  PyObject* res = Py_BuildValue("{s:N,s:N,s:N}",
+    "hw_to_urb", py_candle_channel_histogram_dict(&self->_latency_hw_to_urb),
+    "urb_to_fifo", py_candle_channel_histogram_dict(&self->_latency_urb_to_fifo),
+    "urb_to_read", py_candle_channel_histogram_dict(&self->_latency_urb_to_read)
+  );
+
+  if (res && reset) {
+    histogram_reset(&self->_latency_hw_to_urb);
+    histogram_reset(&self->_latency_urb_to_fifo);
+    histogram_reset(&self->_latency_urb_to_read);
+  }
+
+  return res;
+}
+
+// Returns frame and FIFO counters, optionally resetting them
+PyObject* py_candle_channel_stats(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  int reset = 0;
+  candle_channel_stats_t stats;
+
+  static char* kwlist[] = {"reset", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+    return NULL;
+
+  stats_snapshot(&self->_stats.rx_frames, &self->_stats_base.rx_frames, (int64_t*)&stats, STATS_COUNTER_COUNT(stats));
+  uint64_t overwrites = self->_fifo->overwrite_count;
+  uint64_t prio_overwrites = self->_prio_fifo->overwrite_count;
+  size_t high_water = self->_fifo->high_water;
+
+  if (reset) {
+    stats_reset(&self->_stats.rx_frames, &self->_stats_base.rx_frames, STATS_COUNTER_COUNT(stats));
+    self->_fifo_overwrite_base = overwrites;
+    self->_prio_overwrite_base = prio_overwrites;
+    fifo_reset_high_water(self->_fifo);
+  }
+
+  return Py_BuildValue("{s:L,s:L,s:L,s:L,s:L,s:L,s:K,s:n,s:n,s:n,s:L,s:K,s:n}",
+    "rx_frames", stats.rx_frames,
+    "rx_bytes", stats.rx_bytes,
+    "tx_frames", stats.tx_frames,
+    "tx_bytes", stats.tx_bytes,
+    "tx_errors", stats.tx_errors,
+    "echo_frames", stats.echo_frames,
+    "fifo_overwrites", overwrites - self->_fifo_overwrite_base,
+    "fifo_high_water", (Py_ssize_t)high_water,
+    "fifo_level", (Py_ssize_t)self->_fifo->stored_count,
+    "fifo_size", (Py_ssize_t)self->_fifo->element_count,
+    "priority_frames", stats.priority_frames,
+    "priority_overwrites", prio_overwrites - self->_prio_overwrite_base,
+    "priority_level", (Py_ssize_t)self->_prio_fifo->stored_count
+  );
+}
+
+int py_candle_timeout_converter(PyObject* obj, void* timeout_ms)
+{
+  if (obj == Py_None) {
+    *(uint32_t*)timeout_ms = INFINITE;
+    return 1;
+  }
+
+  unsigned long value = PyLong_AsUnsignedLong(obj);
+  if (PyErr_Occurred())
+    return 0;
+
+  *(uint32_t*)timeout_ms = (uint32_t)value;
+  return 1;
+}
+
+size_t py_candle_channel_wait_any(py_candle_channel** channels, size_t count, uint32_t timeout_ms, bool priority, bool* ready)
+{
+  HANDLE events[MAXIMUM_WAIT_OBJECTS];
+  size_t event_count = 0;
+  uint64_t deadline_us = timing_now_us() + (uint64_t)timeout_ms*1000;
+
+  for (size_t i = 0; i < count; ++i) {
+    events[event_count++] = channels[i]->_fifo->ready_event;
+    if (priority)
+      events[event_count++] = channels[i]->_prio_fifo->ready_event;
+  }
+
+  for (;;) {
+    size_t ready_count = 0;
+
+    // Events stay set while a FIFO holds frames, so every waiter sees them.
+    // Levels are still checked because a reader may drain a FIFO between
+    // the wakeup and this check
+    for (size_t i = 0; i < count; ++i) {
+      ready[i] = channels[i]->_fifo->stored_count > 0 ||
+        (priority && channels[i]->_prio_fifo->stored_count > 0);
+      ready_count += ready[i];
+    }
+
+    if (ready_count)
+      return ready_count;
+
+    DWORD wait_ms = INFINITE;
+    if (timeout_ms != INFINITE) {
+      uint64_t now = timing_now_us();
+      if (now >= deadline_us)
+        return 0;
+      wait_ms = (DWORD)((deadline_us - now + 999)/1000);
+    }
+
+    if (WaitForMultipleObjects((DWORD)event_count, events, false, wait_ms) == WAIT_FAILED)
+      return CANDLE_WAIT_FAILED;
+  }
+}
+
+// Records URB to read latency of frames handed to python
+static void py_candle_channel_record_read_latency(py_candle_channel* self, const candle_frame_t* frames, size_t count)
+{
+  // Only one writer since GIL is held
+  if (!self->_latency_enabled)
+    return;
+
+  uint64_t now = timing_now_us();
+  for (size_t i = 0; i < count; ++i)
+    histogram_record(&self->_latency_urb_to_read, now - frames[i].host_timestamp_us);
+}
+
+size_t py_candle_channel_drain(py_candle_channel* self, candle_frame_t* frames, size_t max_count)
+{
+  size_t count = fifo_get_many(self->_fifo, frames, max_count, 0);
+  py_candle_channel_record_read_latency(self, frames, count);
+
+  return count;
+}
+
+// Sends frame of the TX queue, called on its thread
+static bool py_candle_channel_txq_send(void* ctx, candle_frame_t* frame, uint32_t echo_id)
+{
+  py_candle_channel* self = (py_candle_channel*)ctx;
+
+  bool res = candle_frame_send_echo(self->_handle, self->_ch, frame, echo_id);
+  stats_count_tx(&self->_stats, candle_frame_size(frame), res);
+
+  return res;
+}
+
+// Completes send_async() handle, called by the TX queue without the GIL
+static void py_candle_channel_txq_complete(void* ctx, void* tag, txq_status_t status, uint32_t timestamp_us)
+{
+  py_candle_channel* self = (py_candle_channel*)ctx;
+  py_candle_send_handle* handle = (py_candle_send_handle*)tag;
+
+  py_candle_send_handle_complete(handle, status, timestamp_us);
+
+  AcquireSRWLockExclusive(&self->_send_lock);
+  bool was_empty = !self->_send_done;
+  handle->_next = self->_send_done;
+  self->_send_done = handle;
+  ReleaseSRWLockExclusive(&self->_send_lock);
+
+  if (was_empty && self->_send_notify)
+    notify_signal(self->_send_notify);
+}
+
+static bool py_candle_channel_txq_start(py_candle_channel* self, const uint32_t* depths, size_t class_count, uint8_t slots)
+{
+  txq_t* txq = txq_create(depths, class_count, slots, CANDLE_ECHO_ID_TXQ,
+    py_candle_channel_txq_send, py_candle_channel_txq_complete, self);
+  if (!txq)
+    return false;
+
+  AcquireSRWLockExclusive(&self->_device->_channels_lock);
+  self->_txq = txq;
+  ReleaseSRWLockExclusive(&self->_device->_channels_lock);
+
+  return true;
+}
+
+static int py_candle_channel_future_done(PyObject* future);
+
+// Drops references to completed handles, called with the GIL held. Futures
+// belong to the event loop, so only its reader callback passes resolve and
+// awaited handles are otherwise kept for it. After a failed call into Python
+// the rest is kept and the reader signalled to retry
+static int py_candle_channel_send_release(py_candle_channel* self, bool resolve)
+{
+  int res = 0;
+  py_candle_send_handle* kept = NULL;
+
+  AcquireSRWLockExclusive(&self->_send_lock);
+  py_candle_send_handle* handle = self->_send_done;
+  self->_send_done = NULL;
+  ReleaseSRWLockExclusive(&self->_send_lock);
+
+  while (handle) {
+    py_candle_send_handle* next = handle->_next;
+
+    if (handle->_future) {
+      if (!resolve || res < 0) {
+        handle->_next = kept;
+        kept = handle;
+        handle = next;
+        continue;
+      }
+
+      // Awaiting task may have been cancelled
+      int done = py_candle_channel_future_done(handle->_future);
+      if (!done) {
+        PyObject* value = py_candle_send_handle_value(handle);
+        PyObject* r = value ? PyObject_CallMethod(handle->_future, "set_result", "O", value) : NULL;
+        Py_XDECREF(value);
+        if (r)
+          Py_DECREF(r);
+        else
+          done = -1;
+      }
+      if (done < 0) {
+        // Exception stays set, future is resolved on the next callback
+        res = -1;
+        handle->_next = kept;
+        kept = handle;
+        handle = next;
+        continue;
+      }
+
+      Py_CLEAR(handle->_future);
+      self->_send_waiters--;
+    }
+
+    handle->_channel = NULL;
+    Py_DECREF(handle);
+    handle = next;
+  }
+
+  if (kept) {
+    AcquireSRWLockExclusive(&self->_send_lock);
+    py_candle_send_handle* tail = kept;
+    while (tail->_next)
+      tail = tail->_next;
+    tail->_next = self->_send_done;
+    self->_send_done = kept;
+    ReleaseSRWLockExclusive(&self->_send_lock);
+
+    notify_signal(self->_send_notify);
+  }
+
+  if (resolve && !res && !self->_send_waiters && self->_send_loop) {
+    PyObject* r = PyObject_CallMethod(self->_send_loop, "remove_reader", "n", (Py_ssize_t)notify_fileno(self->_send_notify));
+    Py_CLEAR(self->_send_loop);
+    if (r)
+      Py_DECREF(r);
+    else
+      res = -1;
+  }
+
+  return res;
+}
+
+// Event loop reader callback for awaited handles
+PyObject* py_candle_channel_send_ready(py_candle_channel* self, PyObject* Py_UNUSED(ignored))
+{
+  notify_clear(self->_send_notify);
+
+  if (py_candle_channel_send_release(self, true))
+    return NULL;
+
+  Py_RETURN_NONE;
+}
+
+int py_candle_channel_send_watch(py_candle_channel* self, PyObject* loop)
+{
+  if (self->_send_loop && self->_send_loop != loop) {
+    PyErr_Format(PyExc_RuntimeError, "Sends of this channel are awaited in another event loop.");
+    return -1;
+  }
+
+  if (!self->_send_notify) {
+    notify_t* notify = notify_create();
+    if (!notify) {
+      PyErr_Format(PyExc_OSError, "Unable to create readiness socket.");
+      return -1;
+    }
+
+    // Published after initialization, TX queue signals it right away
+    MemoryBarrier();
+    self->_send_notify = notify;
+  }
+
+  if (!self->_send_loop) {
+    PyObject* callback = PyObject_GetAttrString((PyObject*)self, "_send_ready");
+    if (!callback)
+      return -1;
+
+    PyObject* res = PyObject_CallMethod(loop, "add_reader", "nO", (Py_ssize_t)notify_fileno(self->_send_notify), callback);
+    Py_DECREF(callback);
+    if (!res)
+      return -1;
+    Py_DECREF(res);
+
+    Py_INCREF(loop);
+    self->_send_loop = loop;
+
+    // Handles completed before the reader existed did not signal
+    notify_signal(self->_send_notify);
+  }
+
+  self->_send_waiters++;
+
+  return 0;
+}
+
+// Queues frame without waiting and returns handle completed by its echo, or
+// False if the class is full. Starts TX queue with defaults if not running
+PyObject* py_candle_channel_send_async(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  candle_frame_t frame;
+  uint32_t can_id;
+  uint32_t flags = 0;
+  const uint8_t* buf;
+  Py_ssize_t len;
+  uint8_t cls = 0;
+  uint32_t deadline_ms = INFINITE;
+  bool res;
+
+  static char* kwlist[] = {"can_id", "data", "flags", "cls", "deadline", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "ky#|kbO&", kwlist, &can_id, &buf, &len, &flags, &cls,
+      py_candle_timeout_converter, &deadline_ms))
+    return NULL;
+
+  if (!py_candle_channel_fill_frame(&frame, can_id, buf, len, flags))
+    return NULL;
+
+  // Completed handles of producers that never wait are released here
+  py_candle_channel_send_release(self, false);
+
+  if (!self->_txq) {
+    uint32_t depth = CANDLE_TXQ_DEPTH;
+    if (!py_candle_channel_txq_start(self, &depth, 1, CANDLE_TXQ_SLOTS))
+      return PyErr_Format(PyExc_RuntimeError, "Failed to start TX queue.");
+  }
+
+  py_candle_send_handle* handle = py_candle_send_handle_new(self);
+  if (!handle)
+    return NULL;
+
+  uint64_t deadline_us = deadline_ms == INFINITE ? 0 : timing_now_us() + (uint64_t)deadline_ms*1000;
+
+  // Channel reference, may be completed before push returns
+  Py_INCREF(handle);
+
+  // GIL held like enqueue(), stop_tx_queue may free _txq otherwise
+  res = txq_push(self->_txq, &frame, cls, deadline_us, handle);
+
+  if (!res) {
+    Py_DECREF(handle);
+    Py_DECREF(handle);
+    return Py_BuildValue("O", Py_False);
+  }
+
+  return (PyObject*)handle;
+}
+
+// Starts TX queue ordered by arbitration priority. Depths give the number of
+// classes and how many frames each may hold, slots how many frames are
+// handed to the device before their echo arrives
+PyObject* py_candle_channel_start_tx_queue(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  PyObject* depths_obj = NULL;
+  uint32_t depths[TXQ_MAX_CLASSES] = {CANDLE_TXQ_DEPTH};
+  size_t class_count = 1;
+  uint8_t slots = CANDLE_TXQ_SLOTS;
+
+  static char* kwlist[] = {"depths", "slots", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Ob", kwlist, &depths_obj, &slots))
+    return NULL;
+
+  if (self->_txq)
+    return PyErr_Format(PyExc_RuntimeError, "TX queue is already running.");
+
+  if (!slots || slots > TXQ_MAX_SLOTS)
+    return PyErr_Format(PyExc_ValueError, "Slots must be 1 to %d.", TXQ_MAX_SLOTS);
+
+  if (depths_obj) {
+    PyObject* seq = PySequence_Fast(depths_obj, "Depths must be a sequence.");
+    if (!seq)
+      return NULL;
+
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (!count || count > TXQ_MAX_CLASSES) {
+      Py_DECREF(seq);
+      return PyErr_Format(PyExc_ValueError, "Depths must have 1 to %d classes.", TXQ_MAX_CLASSES);
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i)
+      depths[i] = (uint32_t)PyLong_AsUnsignedLong(PySequence_Fast_GET_ITEM(seq, i));
+    class_count = count;
+    Py_DECREF(seq);
+
+    if (PyErr_Occurred())
+      return NULL;
+  }
+
+  if (!py_candle_channel_txq_start(self, depths, class_count, slots))
+    return Py_BuildValue("O", Py_False);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+// Queued frames that were not sent yet are dropped, their handles cancelled
+PyObject* py_candle_channel_stop_tx_queue(py_candle_channel* self, PyObject* Py_UNUSED(ignored))
+{
+  AcquireSRWLockExclusive(&self->_device->_channels_lock);
+  txq_t* txq = self->_txq;
+  self->_txq = NULL;
+  ReleaseSRWLockExclusive(&self->_device->_channels_lock);
+
+  Py_BEGIN_ALLOW_THREADS
+  txq_delete(txq);
+  Py_END_ALLOW_THREADS
+
+  py_candle_channel_send_release(self, false);
+
+  Py_RETURN_NONE;
+}
+
+// Queues frame in class cls, returns False if the class is full. Frame is
+// dropped if it cannot be sent within deadline ms
+PyObject* py_candle_channel_enqueue(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  candle_frame_t frame;
+  uint32_t can_id;
+  uint32_t flags = 0;
+  const uint8_t* buf;
+  Py_ssize_t len;
+  uint8_t cls = 0;
+  uint32_t deadline_ms = INFINITE;
+  bool res;
+
+  static char* kwlist[] = {"can_id", "data", "flags", "cls", "deadline", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "ky#|kbO&", kwlist, &can_id, &buf, &len, &flags, &cls,
+      py_candle_timeout_converter, &deadline_ms))
+    return NULL;
+
+  if (!self->_txq)
+    return PyErr_Format(PyExc_RuntimeError, "TX queue is not running.");
+
+  if (!py_candle_channel_fill_frame(&frame, can_id, buf, len, flags))
+    return NULL;
+
+  uint64_t deadline_us = deadline_ms == INFINITE ? 0 : timing_now_us() + (uint64_t)deadline_ms*1000;
+
+  // Pushed with the GIL held, stop_tx_queue swaps _txq out under the GIL
+  // and would otherwise free the queue under us. txq_push never blocks
+  res = txq_push(self->_txq, &frame, cls, deadline_us, NULL);
+
+  return Py_BuildValue("O", res ? Py_True : Py_False);
+}
+
+// Returns {queued, sent, send_errors, rejected, stale, echo_timeouts,
+// in_flight, level, levels}
+PyObject* py_candle_channel_tx_queue_stats(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  int reset = 0;
+  txq_stats_t stats;
+  uint32_t levels[TXQ_MAX_CLASSES];
+
+  static char* kwlist[] = {"reset", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+    return NULL;
+
+  if (!self->_txq)
+    return PyErr_Format(PyExc_RuntimeError, "TX queue is not running.");
+
+  txq_stats(self->_txq, &stats, reset);
+  size_t class_count = txq_class_count(self->_txq);
+  size_t level = txq_levels(self->_txq, levels, TXQ_MAX_CLASSES);
+
+  PyObject* level_list = PyList_New(class_count);
+  if (!level_list)
+    return NULL;
+
+  for (size_t i = 0; i < class_count; ++i) {
+    PyObject* item = PyLong_FromUnsignedLong(levels[i]);
+    if (!item) {
+      Py_DECREF(level_list);
+      return NULL;
+    }
+    PyList_SET_ITEM(level_list, i, item);
+  }
+
+  return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:n,s:n,s:N}",
+    "queued", stats.queued,
+    "sent", stats.sent,
+    "send_errors", stats.send_errors,
+    "rejected", stats.rejected,
+    "stale", stats.stale,
+    "echo_timeouts", stats.echo_timeouts,
+    "in_flight", (Py_ssize_t)txq_in_flight(self->_txq),
+    "level", (Py_ssize_t)level,
+    "levels", level_list
+  );
+}
+
+PyObject* py_candle_channel_read(py_candle_channel* self, PyObject* args)
+{
+  uint32_t timeout_ms = 0;
+  bool res;
+
+  if (!PyArg_ParseTuple(args, "|k", &timeout_ms))
+    return NULL;
+
+  candle_frame_t frame;
+
+  Py_BEGIN_ALLOW_THREADS
+  // Read from FIFO which is filled by the RX thread in py_candle_device
+  res = fifo_get(self->_fifo, &frame, timeout_ms);
+  Py_END_ALLOW_THREADS
+
+  if (!res)
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  py_candle_channel_record_read_latency(self, &frame, 1);
+
+  return py_candle_frame_from(&frame);
+}
+
+// Reads from the priority lane only, frames of other ids never wait ahead
+PyObject* py_candle_channel_read_priority(py_candle_channel* self, PyObject* args)
+{
+  uint32_t timeout_ms = 0;
+  bool res;
+
+  if (!PyArg_ParseTuple(args, "|k", &timeout_ms))
+    return NULL;
+
+  candle_frame_t frame;
+
+  Py_BEGIN_ALLOW_THREADS
+  res = fifo_get(self->_prio_fifo, &frame, timeout_ms);
+  Py_END_ALLOW_THREADS
+
+  if (!res)
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  py_candle_channel_record_read_latency(self, &frame, 1);
+
+  return py_candle_frame_from(&frame);
+}
+
+// Reads as many frames as fit into writable buffer, returns their count.
+// Buffer receives packed candle_frame_t records (CANDLE_FRAME_SIZE bytes each)
+PyObject* py_candle_channel_readinto(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  Py_buffer view;
+  uint32_t timeout_ms = 0;
+  size_t count;
+
+  static char* kwlist[] = {"buffer", "timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "w*|k", kwlist, &view, &timeout_ms))
+    return NULL;
+
+  size_t max_frames = view.len / sizeof(candle_frame_t);
+  if (!max_frames) {
+    PyBuffer_Release(&view);
+    return PyErr_Format(PyExc_ValueError, "Buffer is smaller than one frame (%zu bytes).", sizeof(candle_frame_t));
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  // FIFO copies straight into the caller's buffer
+  count = fifo_get_many(self->_fifo, view.buf, max_frames, timeout_ms);
+  Py_END_ALLOW_THREADS
+
+  py_candle_channel_record_read_latency(self, (candle_frame_t*)view.buf, count);
+  PyBuffer_Release(&view);
+
+  if (!count)
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  return PyLong_FromSize_t(count);
+}
+
+
+// Configures iteration: timeout (None waits forever), prefetch batch size and
+// whether timeout ends iteration or raises TimeoutError
+PyObject* py_candle_channel_set_iter_options(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t batch = self->_iter_batch;
+  int stop_on_timeout = self->_iter_stop_on_timeout;
+  uint32_t timeout_ms = INFINITE;
+
+  static char* kwlist[] = {"timeout", "batch", "stop_on_timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O&kp", kwlist, py_candle_timeout_converter, &timeout_ms, &batch, &stop_on_timeout))
+    return NULL;
+
+  if (!batch || batch > CANDLE_ITER_BATCH_MAX)
+    return PyErr_Format(PyExc_ValueError, "Batch size must be 1 to %u.", CANDLE_ITER_BATCH_MAX);
+
+  self->_iter_timeout_ms = timeout_ms;
+  self->_iter_batch = batch;
+  self->_iter_stop_on_timeout = stop_on_timeout;
+
+  Py_RETURN_NONE;
+}
+
+// Waits for frames of an iteration in slices of CANDLE_ITER_SIGNAL_MS so
+// Ctrl-C is handled. Returns -1 with exception set if a signal handler raised
+static Py_ssize_t py_candle_channel_iter_fetch(py_candle_channel* self, candle_frame_t* frames, size_t max_count)
+{
+  uint32_t timeout_ms = self->_iter_timeout_ms;
+  uint64_t deadline_us = timing_now_us() + (uint64_t)timeout_ms*1000;
+  size_t count;
+
+  for (;;) {
+    uint32_t wait_ms = CANDLE_ITER_SIGNAL_MS;
+
+    if (timeout_ms != INFINITE) {
+      uint64_t now = timing_now_us();
+      uint64_t left_ms = now < deadline_us ? (deadline_us - now + 999)/1000 : 0;
+      if (left_ms < wait_ms)
+        wait_ms = (uint32_t)left_ms;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    count = fifo_get_many(self->_fifo, frames, max_count, wait_ms);
+    Py_END_ALLOW_THREADS
+
+    if (count || wait_ms < CANDLE_ITER_SIGNAL_MS)
+      return (Py_ssize_t)count;
+
+    if (PyErr_CheckSignals())
+      return -1;
+  }
+}
+
+// Returns next frame from prefetch buffer, refilling it from the FIFO in a batch
+PyObject* py_candle_channel_iternext(py_candle_channel* self)
+{
+  candle_frame_t frame;
+  Py_ssize_t count;
+
+  if (self->_iter_pos < self->_iter_count)
+    return py_candle_frame_from(&self->_iter_buf[self->_iter_pos++]);
+
+  if (self->_iter_busy) {
+    // Another thread is refilling the buffer, read single frame instead
+    count = py_candle_channel_iter_fetch(self, &frame, 1);
+    if (count < 0)
+      return NULL;
+
+    if (count) {
+      py_candle_channel_record_read_latency(self, &frame, 1);
+      return py_candle_frame_from(&frame);
+    }
+  } else {
+    self->_iter_busy = true;
+    count = py_candle_channel_iter_fetch(self, self->_iter_buf, self->_iter_batch);
+    self->_iter_busy = false;
+
+    if (count < 0)
+      return NULL;
+
+    if (count) {
+      py_candle_channel_record_read_latency(self, self->_iter_buf, count);
+      self->_iter_count = (uint32_t)count;
+      self->_iter_pos = 1;
+      return py_candle_frame_from(&self->_iter_buf[0]);
+    }
+  }
+
+  // Returning NULL without exception ends iteration
+  if (self->_iter_stop_on_timeout)
+    return NULL;
+
+  return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+}
+
+enum {
+  CANDLE_ASYNC_BATCH,
+  CANDLE_ASYNC_NEXT,
+};
+
+static void py_candle_channel_notify(void* ctx)
+{
+  notify_signal((notify_t*)ctx);
+}
+
+// Creates readiness socket on first use
+static notify_t* py_candle_channel_get_notify(py_candle_channel* self)
+{
+  if (!self->_notify) {
+    notify_t* notify = notify_create();
+    if (!notify) {
+      PyErr_Format(PyExc_OSError, "Unable to create readiness socket.");
+      return NULL;
+    }
+
+    self->_notify = notify;
+    fifo_set_ready_callback(self->_fifo, py_candle_channel_notify, notify);
+    fifo_set_ready_callback(self->_prio_fifo, py_candle_channel_notify, notify);
+  }
+
+  return self->_notify;
+}
+
+// Returns socket that becomes readable when the FIFO or the priority lane
+// turns non-empty
+PyObject* py_candle_channel_fileno(py_candle_channel* self, PyObject* Py_UNUSED(ignored))
+{
+  notify_t* notify = py_candle_channel_get_notify(self);
+  if (!notify)
+    return NULL;
+
+  return PyLong_FromSsize_t((Py_ssize_t)notify_fileno(notify));
+}
+
+// Consumes readiness signal, call before draining the FIFO after wakeup
+PyObject* py_candle_channel_clear_ready(py_candle_channel* self, PyObject* Py_UNUSED(ignored))
+{
+  if (self->_notify)
+    notify_clear(self->_notify);
+
+  Py_RETURN_NONE;
+}
+
+static PyObject* py_candle_channel_frames_list(const candle_frame_t* frames, size_t count)
+{
+  PyObject* result = PyList_New(count);
+
+  for (size_t i = 0; result && i < count; ++i) {
+    PyObject* frame = py_candle_frame_from(&frames[i]);
+    if (!frame) {
+      Py_CLEAR(result);
+      break;
+    }
+    PyList_SET_ITEM(result, i, frame);
+  }
+
+  return result;
+}
+
+// Takes available frames for an async read. Returns NULL without exception
+// when there are none
+static PyObject* py_candle_channel_async_collect(py_candle_channel* self, int mode, uint32_t max_frames)
+{
+  if (mode == CANDLE_ASYNC_BATCH) {
+    candle_frame_t* frames = PyMem_RawMalloc(max_frames*sizeof(candle_frame_t));
+    if (!frames)
+      return PyErr_NoMemory();
+
+    size_t count = py_candle_channel_drain(self, frames, max_frames);
+    PyObject* result = count ? py_candle_channel_frames_list(frames, count) : NULL;
+    PyMem_RawFree(frames);
+
+    return result;
+  }
+
+  // Async iteration shares the prefetch buffer with synchronous iteration
+  if (self->_iter_pos >= self->_iter_count && !self->_iter_busy) {
+    self->_iter_count = (uint32_t)py_candle_channel_drain(self, self->_iter_buf, self->_iter_batch);
+    self->_iter_pos = 0;
+  }
+
+  if (self->_iter_pos < self->_iter_count)
+    return py_candle_frame_from(&self->_iter_buf[self->_iter_pos++]);
+
+  return NULL;
+}
+
+// Unregisters reader and drops pending future
+static int py_candle_channel_async_finish(py_candle_channel* self)
+{
+  PyObject* res = PyObject_CallMethod(self->_async_loop, "remove_reader", "n", (Py_ssize_t)notify_fileno(self->_notify));
+
+  Py_CLEAR(self->_async_loop);
+  Py_CLEAR(self->_async_future);
+
+  Py_XDECREF(res);
+  return res ? 0 : -1;
+}
+
+static int py_candle_channel_future_done(PyObject* future)
+{
+  PyObject* done = PyObject_CallMethod(future, "done", NULL);
+  if (!done)
+    return -1;
+
+  int result = PyObject_IsTrue(done);
+  Py_DECREF(done);
+
+  return result;
+}
+
+// Reader callback registered with the event loop
+PyObject* py_candle_channel_async_ready(py_candle_channel* self, PyObject* Py_UNUSED(ignored))
+{
+  if (!self->_async_future)
+    Py_RETURN_NONE;
+
+  notify_clear(self->_notify);
+
+  // Cancelled by the awaiting task, frames stay in the FIFO
+  int done = py_candle_channel_future_done(self->_async_future);
+  if (done) {
+    if (done < 0 || py_candle_channel_async_finish(self))
+      return NULL;
+    Py_RETURN_NONE;
+  }
+
+  PyObject* result = py_candle_channel_async_collect(self, self->_async_mode, self->_async_max_frames);
+  if (!result) {
+    if (PyErr_Occurred())
+      return NULL;
+    Py_RETURN_NONE;
+  }
+
+  PyObject* future = self->_async_future;
+  Py_INCREF(future);
+
+  PyObject* res = NULL;
+  if (!py_candle_channel_async_finish(self))
+    res = PyObject_CallMethod(future, "set_result", "O", result);
+
+  Py_DECREF(future);
+  Py_DECREF(result);
+
+  if (!res)
+    return NULL;
+
+  Py_DECREF(res);
+  Py_RETURN_NONE;
+}
+
+// Done callback of the pending future, unregisters the reader of a future
+// that was cancelled before frames arrived
+PyObject* py_candle_channel_async_done(py_candle_channel* self, PyObject* future)
+{
+  if (self->_async_future == future && py_candle_channel_async_finish(self))
+    return NULL;
+
+  Py_RETURN_NONE;
+}
+
+// Returns future resolved with frames. It completes immediately when the FIFO
+// has data, otherwise once the readiness socket is signalled
+static PyObject* py_candle_channel_async_start(py_candle_channel* self, int mode, uint32_t max_frames)
+{
+  notify_t* notify = py_candle_channel_get_notify(self);
+  if (!notify)
+    return NULL;
+
+  // Previous read stays registered if its future was cancelled
+  if (self->_async_future) {
+    int done = py_candle_channel_future_done(self->_async_future);
+    if (!done)
+      PyErr_Format(PyExc_RuntimeError, "Another asynchronous read is pending on this channel.");
+    if (done <= 0 || py_candle_channel_async_finish(self))
+      return NULL;
+  }
+
+  PyObject* asyncio = PyImport_ImportModule("asyncio");
+  if (!asyncio)
+    return NULL;
+
+  PyObject* loop = PyObject_CallMethod(asyncio, "get_running_loop", NULL);
+  Py_DECREF(asyncio);
+  if (!loop)
+    return NULL;
+
+  PyObject* future = PyObject_CallMethod(loop, "create_future", NULL);
+  if (!future) {
+    Py_DECREF(loop);
+    return NULL;
+  }
+
+  // Signal is consumed before the FIFO is checked so no transition is missed
+  notify_clear(notify);
+
+  PyObject* result = py_candle_channel_async_collect(self, mode, max_frames);
+  PyObject* res = NULL;
+
+  if (result) {
+    res = PyObject_CallMethod(future, "set_result", "O", result);
+    Py_DECREF(result);
+  } else if (!PyErr_Occurred()) {
+    PyObject* callback = PyObject_GetAttrString((PyObject*)self, "_async_ready");
+    if (callback) {
+      res = PyObject_CallMethod(loop, "add_reader", "nO", (Py_ssize_t)notify_fileno(notify), callback);
+      Py_DECREF(callback);
+    }
+
+    if (res) {
+      Py_INCREF(loop);
+      Py_INCREF(future);
+      self->_async_loop = loop;
+      self->_async_future = future;
+      self->_async_mode = mode;
+      self->_async_max_frames = max_frames;
+
+      // Loop reader references the channel, which references the loop. A
+      // cancelled future breaks that cycle right away instead of at the
+      // next frame
+      Py_DECREF(res);
+      callback = PyObject_GetAttrString((PyObject*)self, "_async_done");
+      res = callback ? PyObject_CallMethod(future, "add_done_callback", "O", callback) : NULL;
+      Py_XDECREF(callback);
+
+      if (!res) {
+        PyObject *type, *value, *traceback;
+        PyErr_Fetch(&type, &value, &traceback);
+        py_candle_channel_async_finish(self);
+        PyErr_Restore(type, value, traceback);
+      }
+    }
+  }
+
+  Py_DECREF(loop);
+
+  if (!res) {
+    Py_DECREF(future);
+    return NULL;
+  }
+
+  Py_DECREF(res);
+  return future;
+}
+
+// Awaitable returning list of frames once at least one is available
+PyObject* py_candle_channel_recv_batch(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t max_frames = CANDLE_RX_FIFO_SIZE;
+
+  static char* kwlist[] = {"max_frames", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|I", kwlist, &max_frames))
+    return NULL;
+
+  if (!max_frames)
+    return PyErr_Format(PyExc_ValueError, "max_frames must be positive.");
+
+  return py_candle_channel_async_start(self, CANDLE_ASYNC_BATCH, max_frames);
+}
+
+PyObject* py_candle_channel_anext(py_candle_channel* self)
+{
+  return py_candle_channel_async_start(self, CANDLE_ASYNC_NEXT, 0);
+}
+
+PyAsyncMethods py_candle_channel_async = {
+  .am_aiter = PyObject_SelfIter,
+  .am_anext = (unaryfunc)py_candle_channel_anext,
+};
+
+// Returns new subscription that sees every frame received from now on,
+// independent of read() and other subscriptions. Capacity applies when the
+// shared ring is created by the first call
+PyObject* py_candle_channel_subscribe(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t capacity = CANDLE_BROADCAST_SIZE;
+
+  static char* kwlist[] = {"capacity", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|I", kwlist, &capacity))
+    return NULL;
+
+  if (!capacity)
+    return PyErr_Format(PyExc_ValueError, "Capacity must be positive.");
+
+  if (!self->_broadcast) {
+    broadcast_t* broadcast = broadcast_create(sizeof(candle_frame_t), capacity);
+    if (!broadcast)
+      return PyErr_NoMemory();
+
+    // Published after initialization, RX thread starts writing right away
+    MemoryBarrier();
+    self->_broadcast = broadcast;
+  }
+
+  return PyObject_CallFunction((PyObject*)&py_candle_subscription_type, "O", self);
+}
+
+// Parses int, range or inclusive (first, last) tuple. Ids above 0x7FF or
+// with CANDLE_ID_EXTENDED set are 29 bit ids, a range without the flag must
+// not cross 0x7FF
+static bool py_candle_channel_parse_ids(PyObject* ids, uint32_t* first, uint32_t* last, bool* extended)
+{
+  unsigned long start, end;
+
+  if (PyLong_Check(ids)) {
+    start = end = PyLong_AsUnsignedLong(ids);
+  } else if (PyRange_Check(ids)) {
+    PyObject* r_start = PyObject_GetAttrString(ids, "start");
+    PyObject* r_stop = PyObject_GetAttrString(ids, "stop");
+    PyObject* r_step = PyObject_GetAttrString(ids, "step");
+    long step = r_step ? PyLong_AsLong(r_step) : 0;
+
+    start = r_start ? PyLong_AsUnsignedLong(r_start) : 0;
+    end = r_stop ? PyLong_AsUnsignedLong(r_stop) - 1 : 0;
+
+    Py_XDECREF(r_start);
+    Py_XDECREF(r_stop);
+    Py_XDECREF(r_step);
+
+    if (!PyErr_Occurred() && step != 1) {
+      PyErr_Format(PyExc_ValueError, "Id range step must be 1.");
+      return false;
+    }
+  } else if (!PyArg_ParseTuple(ids, "kk", &start, &end)) {
+    return false;
+  }
+
+  if (PyErr_Occurred())
+    return false;
+
+  // Standard ids of such a range would never match
+  if (!((start | end) & CANDLE_ID_EXTENDED) && start <= 0x7FF && end > 0x7FF) {
+    PyErr_Format(PyExc_ValueError, "Id range crosses 0x7FF, give 11 and 29 bit ids separately.");
+    return false;
+  }
+
+  *extended = (start & CANDLE_ID_EXTENDED) || (end & CANDLE_ID_EXTENDED) || end > 0x7FF;
+  *first = start & 0x1FFFFFFF;
+  *last = end & 0x1FFFFFFF;
+
+  if (*first > *last || (start & ~(CANDLE_ID_EXTENDED | 0x1FFFFFFF)) || (end & ~(CANDLE_ID_EXTENDED | 0x1FFFFFFF))) {
+    PyErr_Format(PyExc_ValueError, "Invalid CAN id range.");
+    return false;
+  }
+
+  return true;
+}
+
+// Routes ids to the priority lane, replacing the previous set. Each item is an
+// int, range or inclusive (first, last) tuple, empty sequence disables the lane
+PyObject* py_candle_channel_set_priority_ids(py_candle_channel* self, PyObject* args)
+{
+  PyObject* ids;
+  uint8_t std[sizeof(self->_prio_std)] = {0};
+  uint32_t ext_first[CANDLE_PRIORITY_MAX_EXT];
+  uint32_t ext_last[CANDLE_PRIORITY_MAX_EXT];
+  uint8_t ext_count = 0;
+
+  if (!PyArg_ParseTuple(args, "O", &ids))
+    return NULL;
+
+  PyObject* seq = PySequence_Fast(ids, "Ids must be a sequence.");
+  if (!seq)
+    return NULL;
+
+  Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    uint32_t first, last;
+    bool extended;
+
+    if (!py_candle_channel_parse_ids(PySequence_Fast_GET_ITEM(seq, i), &first, &last, &extended)) {
+      Py_DECREF(seq);
+      return NULL;
+    }
+
+    if (!extended) {
+      for (uint32_t id = first; id <= last; ++id)
+        std[id >> 3] |= 1 << (id & 7);
+    } else if (ext_count < CANDLE_PRIORITY_MAX_EXT) {
+      ext_first[ext_count] = first;
+      ext_last[ext_count] = last;
+      ext_count++;
+    } else {
+      Py_DECREF(seq);
+      return PyErr_Format(PyExc_ValueError, "Too many extended id ranges (max %d).", CANDLE_PRIORITY_MAX_EXT);
+    }
+  }
+
+  Py_DECREF(seq);
+
+  // RX thread looks ids up with the lock held shared
+  AcquireSRWLockExclusive(&self->_device->_channels_lock);
+  memcpy(self->_prio_std, std, sizeof(std));
+  memcpy(self->_prio_ext_first, ext_first, ext_count*sizeof(uint32_t));
+  memcpy(self->_prio_ext_last, ext_last, ext_count*sizeof(uint32_t));
+  self->_prio_ext_count = ext_count;
+  self->_prio_enabled = count > 0;
+  ReleaseSRWLockExclusive(&self->_device->_channels_lock);
+
+  Py_RETURN_NONE;
+}
+
+// Runs handlers of a batch, called by the dispatcher thread with the GIL held
+static void py_candle_channel_dispatch(py_candle_channel* self, candle_frame_t* frames, size_t count)
+{
+  dispatch_t* dispatch = self->_dispatch;
+
+  py_candle_channel_record_read_latency(self, frames, count);
+  self->_dispatch_batches++;
+
+  for (size_t i = 0; i < count; ++i) {
+    uint16_t index = DISPATCH_NONE;
+
+    if (candle_frame_type(&frames[i]) == CANDLE_FRAMETYPE_RECEIVE)
+      index = dispatch_lookup(dispatch, frames[i].can_id);
+
+    if (index == DISPATCH_NONE) {
+      self->_dispatch_unhandled++;
+      continue;
+    }
+
+    // Handler may change routes, keep callback alive and count before the call
+    PyObject* callback = dispatch->routes[index].ctx;
+    dispatch->routes[index].calls++;
+    Py_INCREF(callback);
+
+    PyObject* frame = py_candle_frame_from(&frames[i]);
+    PyObject* res = frame ? PyObject_CallFunctionObjArgs(callback, frame, NULL) : NULL;
+
+    Py_XDECREF(frame);
+
+    // Exception of one handler must not stop the others
+    if (!res) {
+      index = dispatch_lookup(dispatch, frames[i].can_id);
+      if (index != DISPATCH_NONE && dispatch->routes[index].ctx == callback)
+        dispatch->routes[index].errors++;
+      PyErr_WriteUnraisable(callback);
+    }
+
+    Py_XDECREF(res);
+    Py_DECREF(callback);
+  }
+}
+
+// Channels with running dispatcher threads, linked by _dispatch_next. Only
+// accessed with the GIL held
+static py_candle_channel* py_candle_channel_dispatchers = NULL;
+static bool py_candle_channel_dispatchers_stopped = false;
+
+static void py_candle_channel_dispatch_unlink(py_candle_channel* self)
+{
+  py_candle_channel** link = &py_candle_channel_dispatchers;
+
+  while (*link && *link != self)
+    link = &(*link)->_dispatch_next;
+
+  if (*link)
+    *link = self->_dispatch_next;
+  self->_dispatch_next = NULL;
+}
+
+DWORD WINAPI py_candle_channel_dispatch_thread(LPVOID param)
+{
+  py_candle_channel* self = (py_candle_channel*)param;
+  candle_frame_t frames[CANDLE_DISPATCH_BATCH];
+  bool running = true;
+
+  while (running) {
+    // Frames are collected without the GIL, whole batch runs under one acquisition
+    size_t count = fifo_get_many(self->_fifo, frames, CANDLE_DISPATCH_BATCH, CANDLE_DISPATCH_POLL_MS);
+    if (!count && !self->_dispatch_stop)
+      continue;
+
+    PyGILState_STATE gil = PyGILState_Ensure();
+
+    // Batch taken from the FIFO before a stop request is still handled
+    if (count)
+      py_candle_channel_dispatch(self, frames, count);
+
+    if (self->_dispatch_stop) {
+      running = false;
+    } else if (!self->_dispatch->route_count) {
+      // Last handler removed by a handler, nobody joins this thread
+      CloseHandle(self->_dispatch_thread);
+      self->_dispatch_thread = NULL;
+      py_candle_channel_dispatch_unlink(self);
+      running = false;
+    }
+
+    // Thread reference keeps channel alive while handlers are registered
+    if (!running)
+      Py_DECREF(self);
+
+    PyGILState_Release(gil);
+  }
+
+  return 0;
+}
+
+static bool py_candle_channel_dispatch_start(py_candle_channel* self)
+{
+  // Thread being stopped is restarted by the stopping thread
+  if (self->_dispatch_thread || self->_dispatch_stop)
+    return true;
+
+  if (py_candle_channel_dispatchers_stopped) {
+    PyErr_Format(PyExc_RuntimeError, "Handlers cannot run during interpreter shutdown.");
+    return false;
+  }
+
+  Py_INCREF(self);
+  self->_dispatch_thread = CreateThread(NULL, 0, py_candle_channel_dispatch_thread, (PVOID)self, 0, &self->_dispatch_thread_id);
+
+  if (!self->_dispatch_thread) {
+    Py_DECREF(self);
+    PyErr_Format(PyExc_OSError, "Unable to start dispatcher thread.");
+    return false;
+  }
+
+  self->_dispatch_next = py_candle_channel_dispatchers;
+  py_candle_channel_dispatchers = self;
+
+  return true;
+}
+
+// Stops dispatcher thread once no handlers remain, called with the GIL held
+static bool py_candle_channel_dispatch_stop(py_candle_channel* self)
+{
+  HANDLE thread = self->_dispatch_thread;
+
+  // Dispatcher thread exits by itself after the current batch
+  if (!thread || GetCurrentThreadId() == self->_dispatch_thread_id)
+    return true;
+
+  self->_dispatch_thread = NULL;
+  self->_dispatch_stop = true;
+  py_candle_channel_dispatch_unlink(self);
+
+  Py_BEGIN_ALLOW_THREADS
+  WaitForSingleObject(thread, INFINITE);
+  Py_END_ALLOW_THREADS
+
+  CloseHandle(thread);
+  self->_dispatch_stop = false;
+
+  // Handler registered while waiting, or any handler during shutdown
+  if (self->_dispatch->route_count && !py_candle_channel_dispatchers_stopped)
+    return py_candle_channel_dispatch_start(self);
+
+  return true;
+}
+
+void py_candle_channel_stop_dispatchers(void)
+{
+  py_candle_channel_dispatchers_stopped = true;
+
+  while (py_candle_channel_dispatchers) {
+    // Thread drops its reference when it exits
+    py_candle_channel* channel = py_candle_channel_dispatchers;
+    Py_INCREF(channel);
+
+    if (!py_candle_channel_dispatch_stop(channel))
+      PyErr_WriteUnraisable((PyObject*)channel);
+
+    Py_DECREF(channel);
+  }
+}
+
+// Registers callback(frame) for received frames with id in ids. Handlers run
+// on a dispatcher thread that takes all frames from the channel FIFO
+PyObject* py_candle_channel_on(py_candle_channel* self, PyObject* args)
+{
+  PyObject* ids;
+  PyObject* callback;
+  uint32_t first, last;
+  bool extended;
+
+  if (!PyArg_ParseTuple(args, "OO", &ids, &callback))
+    return NULL;
+
+  if (!PyCallable_Check(callback))
+    return PyErr_Format(PyExc_TypeError, "Callback must be callable.");
+
+  if (!py_candle_channel_parse_ids(ids, &first, &last, &extended))
+    return NULL;
+
+  if (!self->_dispatch) {
+    self->_dispatch = PyMem_RawMalloc(sizeof(dispatch_t));
+    if (!self->_dispatch)
+      return PyErr_NoMemory();
+    dispatch_init(self->_dispatch);
+  }
+
+  if (!dispatch_add(self->_dispatch, first, last, extended, callback))
+    return PyErr_Format(PyExc_ValueError, "Too many handlers (max %u).", DISPATCH_MAX_ROUTES);
+
+  Py_INCREF(callback);
+
+  if (!py_candle_channel_dispatch_start(self))
+    return NULL;
+
+  Py_RETURN_NONE;
+}
+
+// Removes handlers of callback (all if None), returns their count
+PyObject* py_candle_channel_off(py_candle_channel* self, PyObject* args)
+{
+  PyObject* callback = Py_None;
+  size_t removed = 0;
+
+  if (!PyArg_ParseTuple(args, "|O", &callback))
+    return NULL;
+
+  dispatch_t* dispatch = self->_dispatch;
+  if (!dispatch)
+    return PyLong_FromSize_t(0);
+
+  for (size_t i = dispatch->route_count; i-- > 0;) {
+    PyObject* ctx = dispatch->routes[i].ctx;
+    int match = callback == Py_None ? 1 : PyObject_RichCompareBool(ctx, callback, Py_EQ);
+
+    if (match < 0)
+      return NULL;
+
+    if (match) {
+      // Comparison may have run python code that changed routes
+      if (i >= dispatch->route_count || dispatch->routes[i].ctx != ctx)
+        continue;
+      dispatch_remove(dispatch, i);
+      Py_DECREF(ctx);
+      removed++;
+    }
+  }
+
+  if (!dispatch->route_count && !py_candle_channel_dispatch_stop(self))
+    return NULL;
+
+  return PyLong_FromSize_t(removed);
+}
+
+// Returns {batches, unhandled, handlers: [{first, last, extended, callback, calls, errors}]}
+PyObject* py_candle_channel_dispatch_stats(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  int reset = 0;
+
+  static char* kwlist[] = {"reset", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+    return NULL;
+
+  dispatch_t* dispatch = self->_dispatch;
+  size_t route_count = dispatch ? dispatch->route_count : 0;
+
+  PyObject* handlers = PyList_New(route_count);
+  if (!handlers)
+    return NULL;
+
+  for (size_t i = 0; i < route_count; ++i) {
+    dispatch_route_t* route = &dispatch->routes[i];
+    PyObject* handler = Py_BuildValue("{s:k,s:k,s:O,s:O,s:K,s:K}",
+      "first", route->first | (route->extended ? CANDLE_ID_EXTENDED : 0),
+      "last", route->last | (route->extended ? CANDLE_ID_EXTENDED : 0),
+      "extended", route->extended ? Py_True : Py_False,
+      "callback", (PyObject*)route->ctx,
+      "calls", route->calls,
+      "errors", route->errors
+    );
+
+    if (!handler) {
+      Py_DECREF(handlers);
+      return NULL;
+    }
+    PyList_SET_ITEM(handlers, i, handler);
+
+    if (reset) {
+      route->calls = 0;
+      route->errors = 0;
+    }
+  }
+
+  PyObject* res = Py_BuildValue("{s:K,s:K,s:N}",
+    "batches", self->_dispatch_batches,
+    "unhandled", self->_dispatch_unhandled,
+    "handlers", handlers
+  );
+
+  if (reset) {
+    self->_dispatch_batches = 0;
+    self->_dispatch_unhandled = 0;
+  }
+
+  return res;
+}
+
+static const char* py_candle_gateway_ops[] = {"and", "or", "xor", "set", NULL};
+static const char* py_candle_gateway_targets[] = {"id", "dlc", "data", NULL};
+
+static int py_candle_gateway_lookup(const char** names, const char* name)
+{
+  for (int i = 0; names[i]; ++i) {
+    if (!strcmp(names[i], name))
+      return i;
+  }
+  return -1;
+}
+
+// Parses (op, target, value) tuple, value is an int for id and dlc and bytes
+// for data
+static bool py_candle_channel_parse_mod(PyObject* item, gateway_mod_t* mod)
+{
+  const char* op;
+  const char* target;
+  PyObject* value;
+
+  if (!PyArg_ParseTuple(item, "ssO;Modification must be (op, target, value) tuple.", &op, &target, &value))
+    return false;
+
+  int op_index = py_candle_gateway_lookup(py_candle_gateway_ops, op);
+  int target_index = py_candle_gateway_lookup(py_candle_gateway_targets, target);
+
+  if (op_index < 0) {
+    PyErr_Format(PyExc_ValueError, "Unknown modification op %s.", op);
+    return false;
+  }
+  if (target_index < 0) {
+    PyErr_Format(PyExc_ValueError, "Unknown modification target %s.", target);
+    return false;
+  }
+
+  memset(mod, 0, sizeof(gateway_mod_t));
+  mod->op = (uint8_t)op_index;
+  mod->target = (uint8_t)target_index;
+
+  if (mod->target == GATEWAY_TARGET_DATA) {
+    Py_buffer buf;
+    if (PyObject_GetBuffer(value, &buf, PyBUF_SIMPLE) < 0)
+      return false;
+
+    if (buf.len > (Py_ssize_t)sizeof(mod->data)) {
+      PyBuffer_Release(&buf);
+      PyErr_Format(PyExc_ValueError, "Data modification longer than 64 bytes.");
+      return false;
+    }
+
+    memcpy(mod->data, buf.buf, buf.len);
+    mod->len = (uint8_t)buf.len;
+    PyBuffer_Release(&buf);
+  } else {
+    mod->value = (uint32_t)PyLong_AsUnsignedLong(value);
+    if (PyErr_Occurred())
+      return false;
+  }
+
+  return true;
+}
+
+// Forwards frames received on this channel that match can_id/mask to the
+// destination channel, after applying modifications. Returns route id
+PyObject* py_candle_channel_add_route(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  py_candle_channel* dst;
+  PyObject* mods = NULL;
+  gateway_route_t route = {0};
+  uint32_t rate = 0;
+  uint32_t burst = 1;
+  uint8_t max_hops = 1;
+
+  static char* kwlist[] = {"dst", "can_id", "mask", "mods", "rate", "burst", "max_hops", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!|IIOIIb", kwlist, &py_candle_channel_type, &dst,
+      &route.can_id, &route.mask, &mods, &rate, &burst, &max_hops))
+    return NULL;
+
+  if (rate && !burst)
+    return PyErr_Format(PyExc_ValueError, "Burst must be positive.");
+
+  if (mods) {
+    PyObject* seq = PySequence_Fast(mods, "Modifications must be a sequence.");
+    if (!seq)
+      return NULL;
+
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (count > GATEWAY_MAX_MODS) {
+      Py_DECREF(seq);
+      return PyErr_Format(PyExc_ValueError, "Too many modifications (max %d).", GATEWAY_MAX_MODS);
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+      if (!py_candle_channel_parse_mod(PySequence_Fast_GET_ITEM(seq, i), &route.mods[i])) {
+        Py_DECREF(seq);
+        return NULL;
+      }
+    }
+    route.mod_count = (uint8_t)count;
+    Py_DECREF(seq);
+  }
+
+  route.rate = rate;
+  route.burst = burst;
+  route.max_hops = max_hops;
+  route.dst_ctx = dst->_device;
+  route.dst_ch = dst->_ch;
+
+  if (!self->_gateway) {
+    gateway_t* gateway = gateway_create(py_candle_device_send_frame, self->_device, self->_ch);
+    if (!gateway)
+      return PyErr_Format(PyExc_RuntimeError, "Failed to start gateway thread.");
+
+    // Published after initialization, RX thread starts pushing right away
+    MemoryBarrier();
+    self->_gateway = gateway;
+  }
+
+  uint32_t id;
+
+  Py_BEGIN_ALLOW_THREADS
+  id = gateway_add(self->_gateway, &route);
+  Py_END_ALLOW_THREADS
+
+  if (!id)
+    return PyErr_Format(PyExc_ValueError, "Too many routes (max %d).", GATEWAY_MAX_ROUTES);
+
+  // Destination device is kept alive by the route
+  Py_INCREF(dst->_device);
+
+  return PyLong_FromUnsignedLong(id);
+}
+
+PyObject* py_candle_channel_remove_route(py_candle_channel* self, PyObject* args)
+{
+  uint32_t id;
+  void* dst_ctx = NULL;
+  bool res = false;
+
+  if (!PyArg_ParseTuple(args, "I", &id))
+    return NULL;
+
+  if (self->_gateway) {
+    Py_BEGIN_ALLOW_THREADS
+    res = gateway_remove(self->_gateway, id, &dst_ctx);
+    Py_END_ALLOW_THREADS
+  }
+
+  if (!res)
+    return Py_BuildValue("O", Py_False);
+
+  Py_DECREF((PyObject*)dst_ctx);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+// Returns {overruns, routes: [{id, channel, can_id, mask, matched, forwarded,
+// rate_limited, hop_limited, send_errors}]}
+PyObject* py_candle_channel_routes(py_candle_channel* self, PyObject* args, PyObject* kwds)
+{
+  int reset = 0;
+  gateway_route_t routes[GATEWAY_MAX_ROUTES];
+  size_t count = 0;
+  uint64_t overruns = 0;
+
+  static char* kwlist[] = {"reset", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+    return NULL;
+
+  if (self->_gateway) {
+    Py_BEGIN_ALLOW_THREADS
+    count = gateway_routes(self->_gateway, routes, GATEWAY_MAX_ROUTES, reset);
+    Py_END_ALLOW_THREADS
+    overruns = gateway_overruns(self->_gateway);
+  }
+
+  PyObject* list = PyList_New(count);
+  if (!list)
+    return NULL;
+
+  for (size_t i = 0; i < count; ++i) {
+    gateway_route_t* route = &routes[i];
+    PyObject* item = Py_BuildValue("{s:I,s:B,s:I,s:I,s:K,s:K,s:K,s:K,s:K}",
+      "id", route->id,
+      "channel", route->dst_ch,
+      "can_id", route->can_id,
+      "mask", route->mask,
+      "matched", route->matched,
+      "forwarded", route->forwarded,
+      "rate_limited", route->rate_limited,
+      "hop_limited", route->hop_limited,
+      "send_errors", route->send_errors
+    );
+
+    if (!item) {
+      Py_DECREF(list);
+      return NULL;
+    }
+    PyList_SET_ITEM(list, i, item);
+  }
+
+  return Py_BuildValue("{s:K,s:N}", "overruns", overruns, "routes", list);
+}
 
 PyMethodDef py_candle_channel_methods[] = {
   {"start", (PyCFunction)py_candle_channel_start, METH_VARARGS, "Starts CAN channel"},
   {"stop", (PyCFunction)py_candle_channel_stop, METH_NOARGS, "Stops CAN channel"},
   {"set_bitrate", (PyCFunction)py_candle_channel_set_bitrate, METH_VARARGS, "Sets CAN bitrate"},
   {"set_timings", (PyCFunction)py_candle_channel_set_timings, METH_VARARGS | METH_KEYWORDS, "Sets CAN timings"},
+  {"set_data_bitrate", (PyCFunction)py_candle_channel_set_data_bitrate, METH_VARARGS, "Sets CAN FD data phase bitrate"},
+  {"set_data_timings", (PyCFunction)py_candle_channel_set_data_timings, METH_VARARGS | METH_KEYWORDS, "Sets CAN FD data phase timings"},
   {"write", (PyCFunction)py_candle_channel_write, METH_VARARGS, "Send data to CAN"},
+  {"write_at", (PyCFunction)py_candle_channel_write_at, METH_VARARGS | METH_KEYWORDS, "Send data to CAN at specified host or device time"},
+  {"start_tx_queue", (PyCFunction)py_candle_channel_start_tx_queue, METH_VARARGS | METH_KEYWORDS, "Starts TX queue ordered by arbitration priority"},
+  {"stop_tx_queue", (PyCFunction)py_candle_channel_stop_tx_queue, METH_NOARGS, "Stops TX queue"},
+  {"enqueue", (PyCFunction)py_candle_channel_enqueue, METH_VARARGS | METH_KEYWORDS, "Queues frame for transmission by priority"},
+  {"send_async", (PyCFunction)py_candle_channel_send_async, METH_VARARGS | METH_KEYWORDS, "Queues frame and returns awaitable completion handle"},
+  {"_send_ready", (PyCFunction)py_candle_channel_send_ready, METH_NOARGS, "Event loop reader callback of awaited sends"},
+  {"tx_queue_stats", (PyCFunction)py_candle_channel_tx_queue_stats, METH_VARARGS | METH_KEYWORDS, "Returns TX queue counters and levels"},
   {"read", (PyCFunction)py_candle_channel_read, METH_VARARGS, "Read data from CAN"},
+  {"set_priority_ids", (PyCFunction)py_candle_channel_set_priority_ids, METH_VARARGS, "Routes ids to the priority lane"},
+  {"read_priority", (PyCFunction)py_candle_channel_read_priority, METH_VARARGS, "Read frame from the priority lane"},
+  {"set_iter_options", (PyCFunction)py_candle_channel_set_iter_options, METH_VARARGS | METH_KEYWORDS, "Configures timeout and batching of channel iteration"},
+  {"fileno", (PyCFunction)py_candle_channel_fileno, METH_NOARGS, "Returns socket that becomes readable when frames arrive"},
+  {"clear_ready", (PyCFunction)py_candle_channel_clear_ready, METH_NOARGS, "Consumes readiness signal of fileno()"},
+  {"recv_batch", (PyCFunction)py_candle_channel_recv_batch, METH_VARARGS | METH_KEYWORDS, "Awaitable returning list of received frames"},
+  {"_async_ready", (PyCFunction)py_candle_channel_async_ready, METH_NOARGS, "Event loop reader callback"},
+  {"_async_done", (PyCFunction)py_candle_channel_async_done, METH_O, "Done callback of pending asynchronous read"},
+  {"subscribe", (PyCFunction)py_candle_channel_subscribe, METH_VARARGS | METH_KEYWORDS, "Returns independent reader of all received frames"},
+  {"on", (PyCFunction)py_candle_channel_on, METH_VARARGS, "Registers callback for received frames with given ids"},
+  {"off", (PyCFunction)py_candle_channel_off, METH_VARARGS, "Removes handlers of callback"},
+  {"dispatch_stats", (PyCFunction)py_candle_channel_dispatch_stats, METH_VARARGS | METH_KEYWORDS, "Returns handler call counters"},
+  {"add_route", (PyCFunction)py_candle_channel_add_route, METH_VARARGS | METH_KEYWORDS, "Forwards matching received frames to another channel"},
+  {"remove_route", (PyCFunction)py_candle_channel_remove_route, METH_VARARGS, "Removes gateway route"},
+  {"routes", (PyCFunction)py_candle_channel_routes, METH_VARARGS | METH_KEYWORDS, "Returns gateway routes and counters"},
+  {"readinto", (PyCFunction)py_candle_channel_readinto, METH_VARARGS | METH_KEYWORDS, "Read available frames into preallocated buffer"},
+  {"set_berr_reporting", (PyCFunction)py_candle_channel_set_berr_reporting, METH_VARARGS, "Enables bus error reporting on the device"},
+  {"error_stats", (PyCFunction)py_candle_channel_error_stats, METH_VARARGS | METH_KEYWORDS, "Returns error frame counters and bus state"},
+  {"stats", (PyCFunction)py_candle_channel_stats, METH_VARARGS | METH_KEYWORDS, "Returns frame and FIFO counters"},
+  {"set_id_stats", (PyCFunction)py_candle_channel_set_id_stats, METH_VARARGS | METH_KEYWORDS, "Enables per-id period and jitter statistics"},
+  {"id_stats", (PyCFunction)py_candle_channel_id_stats, METH_VARARGS | METH_KEYWORDS, "Returns per-id period and jitter statistics"},
+  {"bus_load", (PyCFunction)py_candle_channel_bus_load_py, METH_VARARGS | METH_KEYWORDS, "Returns bus load computed from on-wire frame length"},
+  {"set_latency_tracking", (PyCFunction)py_candle_channel_set_latency_tracking, METH_VARARGS, "Enables delivery latency histograms"},
+  {"latency_stats", (PyCFunction)py_candle_channel_latency_stats, METH_VARARGS | METH_KEYWORDS, "Returns delivery latency percentiles"},
+  {"decode", (PyCFunction)py_candle_channel_decode, METH_VARARGS | METH_KEYWORDS, "Read batch of frames and decode signals with DBC database"},
+  {"isotp_open", (PyCFunction)py_candle_channel_isotp_open, METH_VARARGS | METH_KEYWORDS, "Opens ISO-TP link for tx_id/rx_id pair"},
+  {"isotp_send", (PyCFunction)py_candle_channel_isotp_send, METH_VARARGS | METH_KEYWORDS, "Sends ISO-TP message"},
+  {"isotp_recv", (PyCFunction)py_candle_channel_isotp_recv, METH_VARARGS | METH_KEYWORDS, "Receives ISO-TP message"},
+  {"uavcan_register", (PyCFunction)py_candle_channel_uavcan_register, METH_VARARGS | METH_KEYWORDS, "Registers UAVCAN data type for transfer reassembly"},
+  {"uavcan_send", (PyCFunction)py_candle_channel_uavcan_send, METH_VARARGS | METH_KEYWORDS, "Sends UAVCAN transfer"},
+  {"uavcan_recv", (PyCFunction)py_candle_channel_uavcan_recv, METH_VARARGS, "Receives reassembled UAVCAN transfer"},
   {NULL}  /* Sentinel */
 };
 
@@ -176,6 +2520,9 @@ PyTypeObject py_candle_channel_type = {
   .tp_new = py_candle_channel_new,
   .tp_init = (initproc)py_candle_channel_init,
   .tp_dealloc = (destructor)py_candle_channel_dealloc,
+  .tp_as_async = &py_candle_channel_async,
+  .tp_iter = PyObject_SelfIter,
+  .tp_iternext = (iternextfunc)py_candle_channel_iternext,
   .tp_members = py_candle_channel_members,
   .tp_methods = py_candle_channel_methods,
 };
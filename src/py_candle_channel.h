@@ -6,9 +6,58 @@
 #include <structmember.h>
 #include "candle_api/candle.h"
 #include "fifo.h"
+#include "isotp.h"
+#include "uavcan.h"
+#include "can_error.h"
+#include "stats.h"
+#include "histogram.h"
+#include "bus_load.h"
+#include "id_stats.h"
+#include "notify.h"
+#include "dispatch.h"
+#include "broadcast.h"
+#include "gateway.h"
+#include "txq.h"
+#include "py_candle_send.h"
 
 #define CANDLE_RX_FIFO_SIZE 20
 
+// Priority lane FIFO, only latency critical ids are routed to it
+#define CANDLE_PRIORITY_FIFO_SIZE 16
+// Extended id ranges of the priority lane (standard ids use a bitmap)
+#define CANDLE_PRIORITY_MAX_EXT 16
+// Channels one wait can watch when priority lanes are included, each takes
+// two wait handles
+#define CANDLE_WAIT_MAX_CHANNELS (MAXIMUM_WAIT_OBJECTS/2)
+
+// Iterator prefetch buffer, refilled from the FIFO in one batch
+#define CANDLE_ITER_BATCH_MAX 64
+// Longest wait of an iteration before signals (Ctrl-C) are checked
+#define CANDLE_ITER_SIGNAL_MS 100
+
+// Default size of the ring shared by subscriptions
+#define CANDLE_BROADCAST_SIZE 1024
+
+// Frames taken from the FIFO per GIL acquisition of the dispatcher thread
+#define CANDLE_DISPATCH_BATCH CANDLE_ITER_BATCH_MAX
+// Interval at which a waiting dispatcher thread checks for stop
+#define CANDLE_DISPATCH_POLL_MS 100
+
+// Echo ids used by write_at to find its echo frame (0 is used by plain
+// writes). Each request takes the next one so a late echo of a timed out
+// request is not mistaken for the current one
+#define CANDLE_ECHO_ID_TIMED 1
+#define CANDLE_ECHO_ID_TIMED_COUNT (CANDLE_ECHO_ID_TXQ - CANDLE_ECHO_ID_TIMED)
+// Echo ids of TX queue slots start here, see txq_create
+#define CANDLE_ECHO_ID_TXQ 0x100
+// Default TX queue depth (single class) and frames in the device at once
+#define CANDLE_TXQ_DEPTH 256
+#define CANDLE_TXQ_SLOTS 4
+// Maximum time to wait for echo of a timed frame
+#define CANDLE_ECHO_TIMEOUT 100 // in ms
+// Initial USB latency estimate until first echo is measured
+#define CANDLE_TX_LATENCY_INIT_US 500
+
 struct py_candle_device;
 
 typedef struct py_candle_channel {
@@ -23,8 +72,165 @@ typedef struct py_candle_channel {
 
   // RX FIFO
   struct fifo_t* _fifo;
+
+  // Priority lane. Received frames with these ids skip the RX FIFO so bursts
+  // of other traffic neither delay nor overwrite them. The id set is changed
+  // with device _channels_lock held exclusive
+  struct fifo_t* _prio_fifo;
+  bool _prio_enabled;
+  uint8_t _prio_std[2048 / 8];
+  uint32_t _prio_ext_first[CANDLE_PRIORITY_MAX_EXT];
+  uint32_t _prio_ext_last[CANDLE_PRIORITY_MAX_EXT];
+  uint8_t _prio_ext_count;
+  uint64_t _prio_overwrite_base;
+
+  // Timed transmission. RX thread signals _echo_event when echo frame
+  // with _echo_wait_id arrives
+  SRWLOCK _write_at_lock;
+  HANDLE _echo_event;
+  volatile uint32_t _echo_wait_id;
+  volatile uint32_t _echo_timestamp_us;
+  // Requests sent so far, selects the echo id of the next one
+  uint32_t _echo_seq;
+  // Measured time from write call to frame on the bus (EWMA)
+  int32_t _tx_latency_us;
+
+  // ISO-TP links, frames with link rx_id are consumed by the engine
+  isotp_link_t* _isotp_links[ISOTP_MAX_LINKS];
+  uint8_t _isotp_link_count;
+
+  // UAVCAN transfer reassembly, created on first data type registration
+  uavcan_t* _uavcan;
+
+  // Decoded error frames (kept out of the RX FIFO) and counter baseline of
+  // last reset
+  can_error_stats_t _error_stats;
+  can_error_counters_t _error_base;
+
+  // Performance counters and baseline of last reset
+  candle_channel_stats_t _stats;
+  candle_channel_stats_t _stats_base;
+  uint64_t _fifo_overwrite_base;
+
+  // Configured bitrates (0 if unknown) and bus load of received and echoed frames
+  uint32_t _bitrate;
+  uint32_t _data_bitrate;
+  bus_load_t _bus_load;
+
+  // Per-id timing statistics, allocated on first enable and kept until
+  // deallocation because RX thread may still be using them
+  id_stats_t* _id_stats;
+  volatile bool _id_stats_enabled;
+
+  // Iterator state, only accessed with the GIL held. Busy flag is set while
+  // the buffer is refilled with the GIL released
+  candle_frame_t _iter_buf[CANDLE_ITER_BATCH_MAX];
+  uint32_t _iter_pos;
+  uint32_t _iter_count;
+  uint32_t _iter_batch;
+  uint32_t _iter_timeout_ms;
+  bool _iter_stop_on_timeout;
+  bool _iter_busy;
+
+  // asyncio support: readiness socket signalled by the RX thread when the
+  // FIFO becomes non-empty, and the read waiting for it
+  notify_t* _notify;
+  PyObject* _async_loop;
+  PyObject* _async_future;
+  int _async_mode;
+  uint32_t _async_max_frames;
+
+  // Ring read by subscriptions, created on first subscribe() and kept until
+  // deallocation because RX thread may still be writing to it
+  broadcast_t* volatile _broadcast;
+
+  // Per-id handlers run by the dispatcher thread, which takes all frames from
+  // the FIFO while handlers are registered. Only accessed with the GIL held
+  dispatch_t* _dispatch;
+  HANDLE _dispatch_thread;
+  DWORD _dispatch_thread_id;
+  volatile bool _dispatch_stop;
+  // Next channel with a running dispatcher thread, see
+  // py_candle_channel_stop_dispatchers
+  struct py_candle_channel* _dispatch_next;
+  uint64_t _dispatch_batches;
+  uint64_t _dispatch_unhandled;
+
+  // Arbitration ordered TX queue, RX thread passes echoes to it with device
+  // _channels_lock held shared
+  txq_t* _txq;
+
+  // send_async() handles completed by the TX queue, pushed without the GIL
+  // and released with it. Channel holds a reference to every handle until
+  // it is taken from this list
+  SRWLOCK _send_lock;
+  py_candle_send_handle* _send_done;
+  // Event loop reader resolving futures of awaited handles
+  notify_t* volatile _send_notify;
+  PyObject* _send_loop;
+  size_t _send_waiters;
+
+  // Routes of received frames to other channels, created on first add_route()
+  // and kept until deallocation because RX thread may still be pushing to it
+  gateway_t* volatile _gateway;
+
+  // Delivery latency histograms, recorded only when enabled
+  volatile bool _latency_enabled;
+  // Device timestamp to URB completion (needs correlated clocks)
+  histogram_t _latency_hw_to_urb;
+  // URB completion to FIFO (RX thread)
+  histogram_t _latency_urb_to_fifo;
+  // URB completion to read() return (RX thread, FIFO and reader)
+  histogram_t _latency_urb_to_read;
 } py_candle_channel;
 
 extern PyTypeObject py_candle_channel_type;
 
+// Fills frame from python write arguments, sets exception on error
+bool py_candle_channel_fill_frame(candle_frame_t* frame, uint32_t can_id, const uint8_t* buf, Py_ssize_t len, uint32_t flags);
+
+// PyArg "O&" converter for timeouts in ms, None means wait forever
+int py_candle_timeout_converter(PyObject* obj, void* timeout_ms);
+
+// Waits until at least one of the channel FIFOs has data, called without the
+// GIL. With priority the priority lanes count as well and at most
+// CANDLE_WAIT_MAX_CHANNELS can be given, each only once. Sets ready flags and
+// returns number of ready channels (0 on timeout), or CANDLE_WAIT_FAILED with
+// the error left in GetLastError()
+#define CANDLE_WAIT_FAILED ((size_t)-1)
+size_t py_candle_channel_wait_any(py_candle_channel** channels, size_t count, uint32_t timeout_ms, bool priority, bool* ready);
+
+// Takes up to max_count frames without waiting, called with the GIL held
+size_t py_candle_channel_drain(py_candle_channel* self, candle_frame_t* frames, size_t max_count);
+
+// Registers awaited pending handle with the event loop reader of its channel,
+// returns -1 with exception set on error
+int py_candle_channel_send_watch(py_candle_channel* self, PyObject* loop);
+
+// Stops all dispatcher threads before interpreter finalization, after which
+// they could no longer take the GIL. Called with the GIL held from atexit,
+// handlers registered later never start a thread
+void py_candle_channel_stop_dispatchers(void);
+
+// Bus load over window ending now, fraction of time the bus was busy
+double py_candle_channel_bus_load(py_candle_channel* self, uint32_t window_ms);
+
+// Returns true if received frame belongs to the priority lane, called by the
+// RX thread
+static inline bool py_candle_channel_is_priority(py_candle_channel* self, uint32_t can_id)
+{
+  if (!(can_id & CANDLE_ID_EXTENDED)) {
+    uint32_t id = can_id & 0x7FF;
+    return (self->_prio_std[id >> 3] >> (id & 7)) & 1;
+  }
+
+  uint32_t id = can_id & 0x1FFFFFFF;
+  for (uint8_t i = 0; i < self->_prio_ext_count; ++i) {
+    if (id >= self->_prio_ext_first[i] && id <= self->_prio_ext_last[i])
+      return true;
+  }
+
+  return false;
+}
+
 #endif
@@ -0,0 +1,241 @@
+#include "py_candle_dbc.h"
+#include <math.h>
+
+void py_candle_dbc_dealloc(py_candle_dbc* self)
+{
+  dbc_free(self->_dbc);
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+PyObject* py_candle_dbc_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  const char* path;
+  char error[256];
+
+  py_candle_dbc* self = (py_candle_dbc*)type->tp_alloc(type, 0);
+
+  if (!self)
+    return NULL;
+
+  if (!PyArg_ParseTuple(args, "s", &path))
+  {
+    type->tp_free((PyObject*)self);
+    return NULL;
+  }
+
+  self->_dbc = dbc_load(path, error, sizeof(error));
+
+  if (!self->_dbc)
+  {
+    type->tp_free((PyObject*)self);
+    return PyErr_Format(PyExc_ValueError, "%s", error);
+  }
+
+  return (PyObject*)self;
+}
+
+int py_candle_dbc_init(py_candle_dbc *self, PyObject *args, PyObject *kwds)
+{
+  return 0;
+}
+
+PyMemberDef py_candle_dbc_members[] = {
+  {NULL}  /* Sentinel */
+};
+
+// Wraps filled bytearray into float64 memoryview (works with numpy.asarray)
+static PyObject* py_candle_dbc_view(PyObject* buf)
+{
+  PyObject* view = PyMemoryView_FromObject(buf);
+  Py_DECREF(buf);
+
+  if (!view)
+    return NULL;
+
+  PyObject* res = PyObject_CallMethod(view, "cast", "s", "d");
+  Py_DECREF(view);
+
+  return res;
+}
+
+// Allocates float64 column, returns pointer to its data
+static double* py_candle_dbc_alloc_column(size_t count, PyObject** buf)
+{
+  *buf = PyByteArray_FromStringAndSize(NULL, count*sizeof(double));
+  if (!*buf)
+    return NULL;
+
+  return (double*)PyByteArray_AS_STRING(*buf);
+}
+
+static bool py_candle_dbc_commit_column(PyObject* dict, const char* name, PyObject* buf)
+{
+  PyObject* view = py_candle_dbc_view(buf);
+  if (!view)
+    return false;
+
+  int res = PyDict_SetItemString(dict, name, view);
+  Py_DECREF(view);
+
+  return res == 0;
+}
+
+PyObject* py_candle_dbc_decode_frames(py_candle_dbc* self, candle_frame_t* frames, size_t count)
+{
+  dbc_t* dbc = self->_dbc;
+  PyObject* result = PyDict_New();
+  PyObject* buf;
+
+  if (!result)
+    return NULL;
+
+  // Group frames by message (counting sort) so each signal is decoded
+  // in a tight loop over frames of the same id with a constant plan
+  size_t* offsets = PyMem_RawCalloc(dbc->message_count + 1, sizeof(size_t));
+  int32_t* msg_index = PyMem_RawMalloc(count*sizeof(int32_t));
+  size_t* order = PyMem_RawMalloc(count*sizeof(size_t));
+  uint8_t (*data)[DBC_DATA_BUF_SIZE] = PyMem_RawCalloc(count, DBC_DATA_BUF_SIZE);
+  uint64_t* mux = PyMem_RawMalloc(count*sizeof(uint64_t));
+
+  if (!offsets || !msg_index || !order || !data || !mux) {
+    PyErr_NoMemory();
+    goto error;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    dbc_message_t* msg = candle_frame_type(&frames[i]) == CANDLE_FRAMETYPE_RECEIVE ?
+      dbc_find_message(dbc, frames[i].can_id) : NULL;
+    msg_index[i] = msg ? (int32_t)(msg - dbc->messages) : -1;
+    if (msg)
+      offsets[msg_index[i] + 1]++;
+  }
+
+  for (size_t m = 0; m < dbc->message_count; ++m)
+    offsets[m + 1] += offsets[m];
+
+  for (size_t i = 0; i < count; ++i) {
+    if (msg_index[i] < 0)
+      continue;
+
+    size_t pos = offsets[msg_index[i]]++;
+    order[pos] = i;
+    memcpy(data[pos], frames[i].data, candle_frame_size(&frames[i]));
+  }
+
+  // offsets now point to the end of each group
+  size_t start = 0;
+
+  for (size_t m = 0; m < dbc->message_count; ++m) {
+    dbc_message_t* msg = &dbc->messages[m];
+    size_t end = offsets[m];
+    size_t n = end - start;
+
+    if (!n)
+      continue;
+
+    PyObject* columns = PyDict_New();
+    if (!columns || PyDict_SetItemString(result, msg->name, columns) < 0) {
+      Py_XDECREF(columns);
+      goto error;
+    }
+    Py_DECREF(columns);
+
+    double* ts = py_candle_dbc_alloc_column(n, &buf);
+    if (!ts)
+      goto error;
+    for (size_t k = 0; k < n; ++k)
+      ts[k] = frames[order[start + k]].timestamp_us;
+    if (!py_candle_dbc_commit_column(columns, "timestamp", buf))
+      goto error;
+
+    if (msg->multiplexor >= 0) {
+      for (size_t k = 0; k < n; ++k)
+        mux[k] = dbc_signal_raw(&msg->signals[msg->multiplexor], data[start + k]);
+    }
+
+    for (size_t s = 0; s < msg->signal_count; ++s) {
+      dbc_signal_t* signal = &msg->signals[s];
+
+      double* values = py_candle_dbc_alloc_column(n, &buf);
+      if (!values)
+        goto error;
+
+      for (size_t k = 0; k < n; ++k) {
+        // Multiplexed signals are only present for matching multiplexor value
+        if (signal->mux == DBC_MUX_MULTIPLEXED && mux[k] != signal->mux_value)
+          values[k] = NAN;
+        else
+          values[k] = dbc_signal_value(signal, data[start + k], candle_frame_size(&frames[order[start + k]]));
+      }
+
+      if (!py_candle_dbc_commit_column(columns, signal->name, buf))
+        goto error;
+    }
+
+    start = end;
+  }
+
+  PyMem_RawFree(offsets);
+  PyMem_RawFree(msg_index);
+  PyMem_RawFree(order);
+  PyMem_RawFree(data);
+  PyMem_RawFree(mux);
+
+  return result;
+
+error:
+  PyMem_RawFree(offsets);
+  PyMem_RawFree(msg_index);
+  PyMem_RawFree(order);
+  PyMem_RawFree(data);
+  PyMem_RawFree(mux);
+  Py_DECREF(result);
+
+  return NULL;
+}
+
+// Returns list of (id, name, [signal names])
+PyObject* py_candle_dbc_messages(py_candle_dbc* self, PyObject* Py_UNUSED(ignored))
+{
+  dbc_t* dbc = self->_dbc;
+  PyObject* list = PyList_New(dbc->message_count);
+
+  if (!list)
+    return NULL;
+
+  for (size_t m = 0; m < dbc->message_count; ++m) {
+    dbc_message_t* msg = &dbc->messages[m];
+    PyObject* signals = PyList_New(msg->signal_count);
+
+    if (!signals) {
+      Py_DECREF(list);
+      return NULL;
+    }
+
+    for (size_t s = 0; s < msg->signal_count; ++s)
+      PyList_SET_ITEM(signals, s, PyUnicode_FromString(msg->signals[s].name));
+
+    PyList_SET_ITEM(list, m, Py_BuildValue("ksN", msg->id, msg->name, signals));
+  }
+
+  return list;
+}
+
+PyMethodDef py_candle_dbc_methods[] = {
+  {"messages", (PyCFunction)py_candle_dbc_messages, METH_NOARGS, "Returns list of messages and their signals"},
+  {NULL}  /* Sentinel */
+};
+
+PyTypeObject py_candle_dbc_type = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "candle_driver.dbc",
+  .tp_doc = "Compiled DBC signal database",
+  .tp_basicsize = sizeof(py_candle_dbc),
+  .tp_itemsize = 0,
+  .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+  .tp_new = py_candle_dbc_new,
+  .tp_init = (initproc)py_candle_dbc_init,
+  .tp_dealloc = (destructor)py_candle_dbc_dealloc,
+  .tp_members = py_candle_dbc_members,
+  .tp_methods = py_candle_dbc_methods,
+};
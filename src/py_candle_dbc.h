@@ -0,0 +1,22 @@
+#ifndef _PY_CANDLE_DBC_H_
+#define _PY_CANDLE_DBC_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include "candle_api/candle.h"
+#include "dbc.h"
+
+typedef struct py_candle_dbc {
+  PyObject_HEAD
+
+  // Compiled signal database
+  dbc_t* _dbc;
+} py_candle_dbc;
+
+extern PyTypeObject py_candle_dbc_type;
+
+// Decodes frames into {message: {signal: float64 memoryview}} dictionary
+PyObject* py_candle_dbc_decode_frames(py_candle_dbc* self, candle_frame_t* frames, size_t count);
+
+#endif
@@ -1,6 +1,9 @@
 #include "py_candle_device.h"
 #include "py_candle_channel.h"
 #include "fifo.h"
+#include "timing.h"
+#include "exporter.h"
+#include "py_candle_frame.h"
 #include <string.h>
 
 // Adds frame to a specified channel FIFO
@@ -11,7 +14,109 @@ void py_candle_device_rx_frame(py_candle_device* device, candle_frame_t* frame)
   // Sanity check and verify that channel is open
   if (ch < CANDLE_MAX_CHANNELS && device->_channels[ch])
   {
-    fifo_t* fifo = device->_channels[ch]->_fifo;
+    py_candle_channel* channel = device->_channels[ch];
+    fifo_t* fifo = channel->_fifo;
+
+    // Other processes get every frame of open channels, including errors
+    if (device->_publisher)
+      shm_publish(device->_publisher, frame);
+
+    // One copy per frame until a trigger fires
+    if (device->_recorder)
+      recorder_add(device->_recorder, frame);
+
+    candle_frametype_t type = candle_frame_type(frame);
+
+    if (type == CANDLE_FRAMETYPE_ECHO) {
+      channel->_stats.echo_frames++;
+
+      // Echo frees a device slot of the TX queue
+      if (channel->_txq)
+        txq_echo(channel->_txq, frame->echo_id, frame->timestamp_us);
+    } else if (type == CANDLE_FRAMETYPE_RECEIVE) {
+      // Only bus traffic is bridged and routed, echoes of forwarded frames
+      // would loop
+      if (device->_bridge)
+        bridge_push(device->_bridge, frame);
+
+      if (channel->_gateway)
+        gateway_push(channel->_gateway, frame);
+
+      channel->_stats.rx_frames++;
+      channel->_stats.rx_bytes += candle_frame_size(frame);
+
+      if (channel->_id_stats_enabled)
+        id_stats_update(channel->_id_stats, frame->can_id, frame->timestamp_us);
+    }
+
+    // Echo means our frame made it to the bus, so both count as bus load.
+    // Device timestamp is more exact than USB arrival, it is mapped to host
+    // time next to the URB timestamp so a stale offset only shifts it by the
+    // drift since the last sync
+    if (type == CANDLE_FRAMETYPE_ECHO || type == CANDLE_FRAMETYPE_RECEIVE) {
+      uint64_t time_us = frame->host_timestamp_us;
+      if (device->_clock_sync_time_us)
+        time_us += (int32_t)(frame->timestamp_us - py_candle_device_device_time_us(device, time_us));
+      bus_load_add(&channel->_bus_load, time_us, frame);
+    }
+
+    // Wake write_at waiting for this echo
+    if (channel->_echo_wait_id && frame->echo_id == channel->_echo_wait_id) {
+      channel->_echo_timestamp_us = frame->timestamp_us;
+      channel->_echo_wait_id = 0;
+      SetEvent(channel->_echo_event);
+    }
+
+    // Error frames only update counters and never reach the data FIFO
+    if (candle_frame_type(frame) == CANDLE_FRAMETYPE_ERROR) {
+      can_error_decode(&channel->_error_stats, frame);
+      return;
+    }
+
+    // Priority frames go straight to their own FIFO, which only other
+    // priority frames can overwrite. Subscriptions and handlers still see
+    // every frame, ISO-TP and UAVCAN links never use priority ids
+    if (channel->_prio_enabled && type == CANDLE_FRAMETYPE_RECEIVE && py_candle_channel_is_priority(channel, frame->can_id)) {
+      channel->_stats.priority_frames++;
+      fifo_add_force(channel->_prio_fifo, frame);
+
+      if (channel->_broadcast)
+        broadcast_write(channel->_broadcast, frame);
+
+      // Dispatcher thread owns the RX FIFO while handlers are registered
+      if (channel->_dispatch_thread)
+        fifo_add_force(fifo, frame);
+      return;
+    }
+
+    // ISO-TP frames are handled here so flow control is answered without the GIL
+    if (candle_frame_type(frame) == CANDLE_FRAMETYPE_RECEIVE) {
+      for (uint8_t i = 0; i < channel->_isotp_link_count; ++i) {
+        if (frame->can_id == channel->_isotp_links[i]->rx_id) {
+          isotp_on_frame(channel->_isotp_links[i], frame);
+          return;
+        }
+      }
+
+      // Frames of registered UAVCAN data types are reassembled into transfers
+      if (channel->_uavcan && uavcan_on_frame(channel->_uavcan, frame))
+        return;
+    }
+
+    if (channel->_latency_enabled) {
+      uint64_t urb_us = frame->host_timestamp_us;
+
+      if (device->_clock_sync_time_us) {
+        int32_t hw_delay = (int32_t)(py_candle_device_device_time_us(device, urb_us) - frame->timestamp_us);
+        histogram_record(&channel->_latency_hw_to_urb, hw_delay > 0 ? hw_delay : 0);
+      }
+
+      histogram_record(&channel->_latency_urb_to_fifo, timing_now_us() - urb_us);
+    }
+
+    // Written once for all subscriptions
+    if (channel->_broadcast)
+      broadcast_write(channel->_broadcast, frame);
 
     // If fifo is full, oldest frames will be pushed out
     fifo_add_force(fifo, frame);
@@ -53,6 +158,21 @@ void insertionSort(candle_frame_t* frames, size_t n, candle_frame_t* frame)
 
 #define RX_REORDER_QUEUE_SIZE 10
 
+// Counts failed candle_frame_read calls, timeouts are not errors
+void py_candle_device_count_read_error(py_candle_device* device)
+{
+  switch (candle_dev_last_error(device->_handle)) {
+    case CANDLE_ERR_READ_TIMEOUT:
+      break;
+    case CANDLE_ERR_READ_SIZE:
+      device->_stats.short_transfers++;
+      break;
+    default:
+      device->_stats.usb_read_errors++;
+      break;
+  }
+}
+
 // RX data processing thread is required for multiple reasons:
 // a) winusb api returns frames out of order if multiple frames are
 //    received between candle_frame_read calls. Some protocols require
@@ -66,25 +186,64 @@ DWORD WINAPI py_candle_device_rx_thread(LPVOID lpParam)
   py_candle_device* device = (py_candle_device*)lpParam;
   candle_frame_t frames[RX_REORDER_QUEUE_SIZE];
   size_t received_frames = 0;
+  // Device was synced when opened
+  uint64_t next_sync_us = timing_now_us() + CANDLE_CLOCK_SYNC_INTERVAL_US;
 
   while (!device->_rx_thread_stop_req) {
     received_frames = 0;
 
+    // Keep host and device clock correlation fresh, read timeout bounds how
+    // late this runs on a quiet bus. Failed syncs are not retried sooner
+    uint64_t now_us = timing_now_us();
+    if (now_us >= next_sync_us) {
+      py_candle_device_sync_clock(device);
+      next_sync_us = now_us + CANDLE_CLOCK_SYNC_INTERVAL_US;
+    }
+
     // Read first frame with timeout so thread sleeps instead of wasting cpu cycles
-    if (!candle_frame_read(device->_handle, &frames[received_frames++], CANDLE_RX_THREAD_INTERVAL))
+    if (!candle_frame_read(device->_handle, &frames[received_frames++], CANDLE_RX_THREAD_INTERVAL)) {
+      py_candle_device_count_read_error(device);
+
+      // Post-trigger window also has to end on a quiet bus
+      AcquireSRWLockShared(&device->_channels_lock);
+      if (device->_recorder)
+        recorder_poll(device->_recorder);
+      ReleaseSRWLockShared(&device->_channels_lock);
       continue;
+    }
+
+    // Driver does not know the host clock, stamp arrival before sorting
+    frames[0].host_timestamp_us = timing_now_us();
+    device->_stats.rx_wakeups++;
 
     // Read remaining frames that are in rx buffer and need to be reordered
     candle_frame_t frame;
-    while (candle_frame_read(device->_handle, &frame, 0) && received_frames < RX_REORDER_QUEUE_SIZE) {
+    while (received_frames < RX_REORDER_QUEUE_SIZE) {
+      if (!candle_frame_read(device->_handle, &frame, 0)) {
+        py_candle_device_count_read_error(device);
+        break;
+      }
+
+      frame.host_timestamp_us = timing_now_us();
+
       // sort frame into array
       insertionSort(frames, received_frames, &frame);
       ++received_frames;
     }
 
+    // Frame older than already pushed one means reorder queue was too small
+    if (device->_last_timestamp_valid && (int32_t)(frames[0].timestamp_us - device->_last_timestamp_us) < 0)
+      device->_stats.reorder_violations++;
+
+    device->_last_timestamp_us = frames[received_frames - 1].timestamp_us;
+    device->_last_timestamp_valid = true;
+    device->_stats.rx_frames += received_frames;
+
     // push sorted frames to FIFOs
+    AcquireSRWLockShared(&device->_channels_lock);
     for (size_t i = 0; i < received_frames; ++i)
       py_candle_device_rx_frame(device, &frames[i]);
+    ReleaseSRWLockShared(&device->_channels_lock);
   }
 
   return 0;
@@ -109,16 +268,53 @@ void py_candle_device_stop_rx_thread(py_candle_device* self)
   }
 }
 
+bool py_candle_device_sync_clock(py_candle_device* self)
+{
+  uint32_t device_us;
+
+  uint64_t t0 = timing_now_us();
+  if (!candle_dev_get_timestamp_us(self->_handle, &device_us))
+    return false;
+  uint64_t t1 = timing_now_us();
+
+  // Assume device sampled its timer in the middle of the control transfer
+  self->_clock_offset_us = (int64_t)(t0 + (t1 - t0)/2) - device_us;
+  self->_clock_sync_time_us = t1;
+
+  return true;
+}
+
+uint64_t py_candle_device_host_time_us(py_candle_device* self, uint32_t device_us)
+{
+  uint64_t now = timing_now_us();
+
+  // Device timestamp wraps every ~71 minutes so resolve it relative to current time
+  int32_t diff = (int32_t)(device_us - py_candle_device_device_time_us(self, now));
+
+  return now + diff;
+}
+
+uint32_t py_candle_device_device_time_us(py_candle_device* self, uint64_t host_us)
+{
+  return (uint32_t)(host_us - self->_clock_offset_us);
+}
+
 // called by the channel destructor
 void py_candle_device_close_channel(py_candle_device* self, uint8_t ch)
 {
   // This prevents RX thread from writing non existing FIFO
+  AcquireSRWLockExclusive(&self->_channels_lock);
   self->_channels[ch] = NULL;
+  ReleaseSRWLockExclusive(&self->_channels_lock);
 }
 
 void py_candle_device_dealloc(py_candle_device* self)
 {
+  exporter_delete(self->_exporter);
   py_candle_device_stop_rx_thread(self);
+  shm_publisher_delete(self->_publisher);
+  bridge_delete(self->_bridge);
+  recorder_delete(self->_recorder);
   candle_dev_close(self->_handle);
   candle_dev_free(self->_handle);
   Py_TYPE(self)->tp_free((PyObject*)self);
@@ -140,7 +336,19 @@ PyObject* py_candle_device_new(PyTypeObject *type, PyObject *args, PyObject *kwd
 
   self->_rx_thread = NULL;
   self->_rx_thread_stop_req = false;
+  self->_clock_offset_us = 0;
+  self->_clock_sync_time_us = 0;
+  memset(&self->_stats, 0, sizeof(self->_stats));
+  memset(&self->_stats_base, 0, sizeof(self->_stats_base));
+  self->_stats_reset_time_us = timing_now_us();
+  self->_last_timestamp_valid = false;
   memset(self->_channels, 0, sizeof(self->_channels));
+  InitializeSRWLock(&self->_channels_lock);
+  self->_exporter = NULL;
+  self->_publisher = NULL;
+  self->_bridge = NULL;
+  self->_recorder = NULL;
+  self->_read_any_start = 0;
 
   return (PyObject*)self;
 }
@@ -169,6 +377,7 @@ PyObject* py_candle_device_open(py_candle_device* self, PyObject* Py_UNUSED(igno
   if (!candle_dev_open(self->_handle))
     return Py_BuildValue("O", Py_False);
 
+  py_candle_device_sync_clock(self);
   py_candle_device_start_rx_thread(self);
 
   return Py_BuildValue("O", Py_True);
@@ -269,6 +478,619 @@ PyObject* py_candle_device_timestamp(py_candle_device* self, PyObject* Py_UNUSED
   return Py_BuildValue("k", timestamp);
 }
 
+// Returns RX thread counters, optionally resetting them
+PyObject* py_candle_device_stats(py_candle_device* self, PyObject* args, PyObject* kwds)
+{
+  int reset = 0;
+  candle_device_stats_t stats;
+
+  static char* kwlist[] = {"reset", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+    return NULL;
+
+  stats_snapshot(&self->_stats.rx_frames, &self->_stats_base.rx_frames, (int64_t*)&stats, STATS_COUNTER_COUNT(stats));
+
+  uint64_t now = timing_now_us();
+  double elapsed = (now - self->_stats_reset_time_us) / 1e6;
+
+  if (reset) {
+    stats_reset(&self->_stats.rx_frames, &self->_stats_base.rx_frames, STATS_COUNTER_COUNT(stats));
+    self->_stats_reset_time_us = now;
+  }
+
+  return Py_BuildValue("{s:L,s:L,s:d,s:L,s:L,s:L,s:d}",
+    "rx_frames", stats.rx_frames,
+    "rx_wakeups", stats.rx_wakeups,
+    "rx_wakeups_per_sec", elapsed > 0 ? stats.rx_wakeups / elapsed : 0.0,
+    "usb_read_errors", stats.usb_read_errors,
+    "short_transfers", stats.short_transfers,
+    "reorder_violations", stats.reorder_violations,
+    "interval", elapsed
+  );
+}
+
+// Waits for data on any open channel and drains ready channels into a list
+// of frames, grouped by channel. The first channel drained rotates between
+// calls so a busy low channel cannot fill every batch
+PyObject* py_candle_device_read_any(py_candle_device* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t timeout_ms = 0;
+  uint32_t max_frames = CANDLE_READ_ANY_MAX_FRAMES;
+  py_candle_channel* channels[CANDLE_MAX_CHANNELS];
+  bool ready[CANDLE_MAX_CHANNELS];
+  size_t count = 0;
+  size_t frame_count = 0;
+
+  static char* kwlist[] = {"timeout", "max_frames", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O&k", kwlist, py_candle_timeout_converter, &timeout_ms, &max_frames))
+    return NULL;
+
+  if (!max_frames)
+    return PyList_New(0);
+
+  // Channels are referenced so they outlive the wait without the GIL
+  for (uint8_t ch = 0; ch < CANDLE_MAX_CHANNELS; ++ch) {
+    if (self->_channels[ch]) {
+      Py_INCREF(self->_channels[ch]);
+      channels[count++] = self->_channels[ch];
+    }
+  }
+
+  if (!count)
+    return PyErr_Format(PyExc_ValueError, "No open channels.");
+
+  candle_frame_t* frames = PyMem_RawMalloc(max_frames*sizeof(candle_frame_t));
+  size_t ready_count = 0;
+  DWORD error = 0;
+
+  if (frames) {
+    Py_BEGIN_ALLOW_THREADS
+    // Only the RX FIFOs are drained, priority lanes are read on their own
+    ready_count = py_candle_channel_wait_any(channels, count, timeout_ms, false, ready);
+    if (ready_count == CANDLE_WAIT_FAILED)
+      error = GetLastError();
+    Py_END_ALLOW_THREADS
+
+    size_t start = self->_read_any_start % count;
+    self->_read_any_start = start + 1;
+
+    for (size_t n = 0; ready_count != CANDLE_WAIT_FAILED && n < count && frame_count < max_frames; ++n) {
+      size_t i = (start + n) % count;
+      if (ready[i])
+        frame_count += py_candle_channel_drain(channels[i], frames + frame_count, max_frames - frame_count);
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i)
+    Py_DECREF(channels[i]);
+
+  if (!frames)
+    return PyErr_NoMemory();
+
+  if (ready_count == CANDLE_WAIT_FAILED) {
+    PyMem_RawFree(frames);
+    return PyErr_SetFromWindowsErr((int)error);
+  }
+
+  if (!frame_count) {
+    PyMem_RawFree(frames);
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+  }
+
+  PyObject* result = PyList_New(frame_count);
+  for (size_t i = 0; result && i < frame_count; ++i) {
+    PyObject* frame = py_candle_frame_from(&frames[i]);
+    if (!frame) {
+      Py_CLEAR(result);
+      break;
+    }
+    PyList_SET_ITEM(result, i, frame);
+  }
+
+  PyMem_RawFree(frames);
+
+  return result;
+}
+
+typedef struct metric_desc_t {
+  const char* name;
+  const char* type;
+  const char* help;
+} metric_desc_t;
+
+enum {
+  METRIC_RX_FRAMES,
+  METRIC_RX_BYTES,
+  METRIC_TX_FRAMES,
+  METRIC_TX_BYTES,
+  METRIC_TX_ERRORS,
+  METRIC_FIFO_OVERWRITES,
+  METRIC_FIFO_LEVEL,
+  METRIC_FIFO_HIGH_WATER,
+  METRIC_BUS_STATE,
+  METRIC_BUS_TX_ERRORS,
+  METRIC_BUS_RX_ERRORS,
+  METRIC_ERROR_FRAMES,
+  METRIC_BUS_OFF,
+  METRIC_BUS_LOAD,
+  METRIC_CHANNEL_COUNT
+};
+
+static const metric_desc_t channel_metrics[METRIC_CHANNEL_COUNT] = {
+  {"candle_rx_frames_total", "counter", "Received frames"},
+  {"candle_rx_bytes_total", "counter", "Received data bytes"},
+  {"candle_tx_frames_total", "counter", "Transmitted frames"},
+  {"candle_tx_bytes_total", "counter", "Transmitted data bytes"},
+  {"candle_tx_errors_total", "counter", "Failed frame transmissions"},
+  {"candle_fifo_overwrites_total", "counter", "Frames dropped because RX FIFO was full"},
+  {"candle_fifo_level", "gauge", "Frames waiting in RX FIFO"},
+  {"candle_fifo_high_water", "gauge", "Highest RX FIFO level since last stats reset"},
+  {"candle_bus_state", "gauge", "CAN state (0 active, 1 warning, 2 passive, 3 bus off)"},
+  {"candle_bus_tx_error_counter", "gauge", "Transmit error counter"},
+  {"candle_bus_rx_error_counter", "gauge", "Receive error counter"},
+  {"candle_error_frames_total", "counter", "Received error frames"},
+  {"candle_bus_off_total", "counter", "Bus off events"},
+  {"candle_bus_load", "gauge", "Fraction of last second the bus was busy"},
+};
+
+// Copies channel counters, called with channels lock held
+static void py_candle_device_channel_metrics(py_candle_channel* channel, double* values)
+{
+  values[METRIC_RX_FRAMES] = channel->_stats.rx_frames;
+  values[METRIC_RX_BYTES] = channel->_stats.rx_bytes;
+  values[METRIC_TX_FRAMES] = channel->_stats.tx_frames;
+  values[METRIC_TX_BYTES] = channel->_stats.tx_bytes;
+  values[METRIC_TX_ERRORS] = channel->_stats.tx_errors;
+  // FIFO fields are read without the FIFO lock, aligned reads are atomic
+  values[METRIC_FIFO_OVERWRITES] = channel->_fifo->overwrite_count;
+  values[METRIC_FIFO_LEVEL] = channel->_fifo->stored_count;
+  values[METRIC_FIFO_HIGH_WATER] = channel->_fifo->high_water;
+  values[METRIC_BUS_STATE] = channel->_error_stats.state;
+  values[METRIC_BUS_TX_ERRORS] = channel->_error_stats.tx_errors;
+  values[METRIC_BUS_RX_ERRORS] = channel->_error_stats.rx_errors;
+  values[METRIC_ERROR_FRAMES] = channel->_error_stats.counters.error_frames;
+  values[METRIC_BUS_OFF] = channel->_error_stats.counters.bus_off_count;
+  values[METRIC_BUS_LOAD] = py_candle_channel_bus_load(channel, 1000);
+}
+
+static void py_candle_device_render_metric(char* buf, size_t size, size_t* len, const char* label,
+  const char* name, const char* type, const char* help, int64_t value)
+{
+  exporter_printf(buf, size, len, "# HELP %s %s\n# TYPE %s %s\n%s{device=\"%s\"} %lld\n",
+    name, help, name, type, name, label, (long long)value);
+}
+
+// Renders metrics in Prometheus text format, runs on the exporter thread
+static size_t py_candle_device_render_metrics(void* ctx, char* buf, size_t size)
+{
+  py_candle_device* device = (py_candle_device*)ctx;
+  const char* label = device->_metrics_label;
+  double values[CANDLE_MAX_CHANNELS][METRIC_CHANNEL_COUNT];
+  bool present[CANDLE_MAX_CHANNELS];
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  double cpu_seconds = 0;
+  size_t len = 0;
+
+  // Lock only protects against channel deallocation, counters are read as is
+  AcquireSRWLockShared(&device->_channels_lock);
+  for (uint8_t ch = 0; ch < CANDLE_MAX_CHANNELS; ++ch) {
+    present[ch] = device->_channels[ch] != NULL;
+    if (present[ch])
+      py_candle_device_channel_metrics(device->_channels[ch], values[ch]);
+  }
+  ReleaseSRWLockShared(&device->_channels_lock);
+
+  HANDLE rx_thread = device->_rx_thread;
+  if (rx_thread && GetThreadTimes(rx_thread, &creation_time, &exit_time, &kernel_time, &user_time)) {
+    // FILETIME is in 100ns units
+    uint64_t kernel = ((uint64_t)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime;
+    uint64_t user = ((uint64_t)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime;
+    cpu_seconds = (kernel + user) / 1e7;
+  }
+
+  py_candle_device_render_metric(buf, size, &len, label, "candle_rx_thread_wakeups_total", "counter",
+    "RX thread wake ups with at least one frame", device->_stats.rx_wakeups);
+  py_candle_device_render_metric(buf, size, &len, label, "candle_usb_read_errors_total", "counter",
+    "Failed USB reads", device->_stats.usb_read_errors);
+  py_candle_device_render_metric(buf, size, &len, label, "candle_usb_short_transfers_total", "counter",
+    "USB transfers shorter than a frame", device->_stats.short_transfers);
+  py_candle_device_render_metric(buf, size, &len, label, "candle_rx_reorder_violations_total", "counter",
+    "Frames older than previously delivered frames", device->_stats.reorder_violations);
+
+  exporter_printf(buf, size, &len, "# HELP candle_rx_thread_cpu_seconds_total RX thread CPU time\n"
+    "# TYPE candle_rx_thread_cpu_seconds_total counter\n"
+    "candle_rx_thread_cpu_seconds_total{device=\"%s\"} %.6f\n", label, cpu_seconds);
+
+  for (int m = 0; m < METRIC_CHANNEL_COUNT; ++m) {
+    const metric_desc_t* desc = &channel_metrics[m];
+
+    exporter_printf(buf, size, &len, "# HELP %s %s\n# TYPE %s %s\n", desc->name, desc->help, desc->name, desc->type);
+    for (uint8_t ch = 0; ch < CANDLE_MAX_CHANNELS; ++ch) {
+      if (present[ch])
+        exporter_printf(buf, size, &len, "%s{device=\"%s\",channel=\"%u\"} %.15g\n",
+          desc->name, label, ch, values[ch][m]);
+    }
+  }
+
+  return len;
+}
+
+// Starts HTTP server exposing device and channel counters for Prometheus
+PyObject* py_candle_device_start_exporter(py_candle_device* self, PyObject* args, PyObject* kwds)
+{
+  unsigned short port;
+  const char* address = "127.0.0.1";
+
+  static char* kwlist[] = {"port", "address", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "H|s", kwlist, &port, &address))
+    return NULL;
+
+  if (self->_exporter)
+    return PyErr_Format(PyExc_RuntimeError, "Exporter is already running.");
+
+  PyObject* name = py_candle_device_name(self, NULL);
+  if (!name)
+    return NULL;
+
+  snprintf(self->_metrics_label, sizeof(self->_metrics_label), "%s", PyUnicode_AsUTF8(name));
+  Py_DECREF(name);
+
+  exporter_t* exporter;
+
+  Py_BEGIN_ALLOW_THREADS
+  exporter = exporter_create(address, port, py_candle_device_render_metrics, self);
+  Py_END_ALLOW_THREADS
+
+  if (!exporter)
+    return Py_BuildValue("O", Py_False);
+
+  self->_exporter = exporter;
+
+  return Py_BuildValue("O", Py_True);
+}
+
+PyObject* py_candle_device_stop_exporter(py_candle_device* self, PyObject* Py_UNUSED(ignored))
+{
+  exporter_t* exporter = self->_exporter;
+  self->_exporter = NULL;
+
+  Py_BEGIN_ALLOW_THREADS
+  exporter_delete(exporter);
+  Py_END_ALLOW_THREADS
+
+  Py_RETURN_NONE;
+}
+
+// Sends frame on the channel given by frame->channel if it is open. Used by
+// the shared memory publisher, bridge and gateway threads
+bool py_candle_device_send_frame(void* ctx, const void* item)
+{
+  py_candle_device* self = (py_candle_device*)ctx;
+  candle_frame_t frame = *(const candle_frame_t*)item;
+  bool res = false;
+
+  AcquireSRWLockShared(&self->_channels_lock);
+
+  if (frame.channel < CANDLE_MAX_CHANNELS && self->_channels[frame.channel]) {
+    py_candle_channel* channel = self->_channels[frame.channel];
+
+    res = candle_frame_send(self->_handle, frame.channel, &frame);
+    stats_count_tx(&channel->_stats, candle_frame_size(&frame), res);
+  }
+
+  ReleaseSRWLockShared(&self->_channels_lock);
+
+  return res;
+}
+
+// Publishes received frames of open channels into named shared memory for
+// candle_driver.SharedReader in other processes
+PyObject* py_candle_device_start_publisher(py_candle_device* self, PyObject* args, PyObject* kwds)
+{
+  const char* name;
+  uint32_t capacity = CANDLE_PUBLISHER_SIZE;
+
+  static char* kwlist[] = {"name", "capacity", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|I", kwlist, &name, &capacity))
+    return NULL;
+
+  if (self->_publisher)
+    return PyErr_Format(PyExc_RuntimeError, "Publisher is already running.");
+
+  shm_publisher_t* publisher;
+
+  Py_BEGIN_ALLOW_THREADS
+  publisher = shm_publisher_create(name, sizeof(candle_frame_t), capacity, py_candle_device_send_frame, self);
+  Py_END_ALLOW_THREADS
+
+  if (!publisher)
+    return Py_BuildValue("O", Py_False);
+
+  AcquireSRWLockExclusive(&self->_channels_lock);
+  self->_publisher = publisher;
+  ReleaseSRWLockExclusive(&self->_channels_lock);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+PyObject* py_candle_device_stop_publisher(py_candle_device* self, PyObject* Py_UNUSED(ignored))
+{
+  // Unlinked first so RX thread stops publishing before the ring goes away
+  AcquireSRWLockExclusive(&self->_channels_lock);
+  shm_publisher_t* publisher = self->_publisher;
+  self->_publisher = NULL;
+  ReleaseSRWLockExclusive(&self->_channels_lock);
+
+  Py_BEGIN_ALLOW_THREADS
+  shm_publisher_delete(publisher);
+  Py_END_ALLOW_THREADS
+
+  Py_RETURN_NONE;
+}
+
+// Returns {tx_rejected, readers: [{pid, pending, dropped}]}
+PyObject* py_candle_device_publisher_stats(py_candle_device* self, PyObject* Py_UNUSED(ignored))
+{
+  shm_reader_info_t info[SHM_MAX_READERS];
+
+  if (!self->_publisher)
+    return PyErr_Format(PyExc_RuntimeError, "Publisher is not running.");
+
+  size_t count = shm_publisher_readers(self->_publisher, info, SHM_MAX_READERS);
+
+  PyObject* readers = PyList_New(count);
+  if (!readers)
+    return NULL;
+
+  for (size_t i = 0; i < count; ++i) {
+    PyObject* reader = Py_BuildValue("{s:k,s:L,s:K}",
+      "pid", (unsigned long)info[i].pid,
+      "pending", (long long)info[i].pending,
+      "dropped", (unsigned long long)info[i].dropped
+    );
+
+    if (!reader) {
+      Py_DECREF(readers);
+      return NULL;
+    }
+    PyList_SET_ITEM(readers, i, reader);
+  }
+
+  return Py_BuildValue("{s:K,s:N}",
+    "tx_rejected", (unsigned long long)shm_publisher_tx_rejected(self->_publisher),
+    "readers", readers
+  );
+}
+
+// Starts CAN over UDP bridge to a peer (another process or host running
+// start_bridge). Batch timeout is in us, 0 sends every RX batch right away.
+// Binds to loopback unless another local address is given, only datagrams
+// from the remote peer are accepted
+PyObject* py_candle_device_start_bridge(py_candle_device* self, PyObject* args, PyObject* kwds)
+{
+  const char* remote;
+  unsigned short remote_port = BRIDGE_DEFAULT_PORT;
+  unsigned short port = BRIDGE_DEFAULT_PORT;
+  const char* address = "127.0.0.1";
+  uint32_t batch_timeout_us = 1000;
+
+  static char* kwlist[] = {"remote", "remote_port", "port", "address", "batch_timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|HHsI", kwlist, &remote, &remote_port, &port, &address, &batch_timeout_us))
+    return NULL;
+
+  if (self->_bridge)
+    return PyErr_Format(PyExc_RuntimeError, "Bridge is already running.");
+
+  bridge_t* bridge;
+
+  Py_BEGIN_ALLOW_THREADS
+  bridge = bridge_create(address, port, remote, remote_port, batch_timeout_us, py_candle_device_send_frame, self);
+  Py_END_ALLOW_THREADS
+
+  if (!bridge)
+    return Py_BuildValue("O", Py_False);
+
+  AcquireSRWLockExclusive(&self->_channels_lock);
+  self->_bridge = bridge;
+  ReleaseSRWLockExclusive(&self->_channels_lock);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+PyObject* py_candle_device_stop_bridge(py_candle_device* self, PyObject* Py_UNUSED(ignored))
+{
+  // Unlinked first so RX thread stops pushing before the bridge goes away
+  AcquireSRWLockExclusive(&self->_channels_lock);
+  bridge_t* bridge = self->_bridge;
+  self->_bridge = NULL;
+  ReleaseSRWLockExclusive(&self->_channels_lock);
+
+  Py_BEGIN_ALLOW_THREADS
+  bridge_delete(bridge);
+  Py_END_ALLOW_THREADS
+
+  Py_RETURN_NONE;
+}
+
+PyObject* py_candle_device_bridge_stats(py_candle_device* self, PyObject* Py_UNUSED(ignored))
+{
+  if (!self->_bridge)
+    return PyErr_Format(PyExc_RuntimeError, "Bridge is not running.");
+
+  bridge_stats_t stats = *bridge_stats(self->_bridge);
+
+  return Py_BuildValue("{s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L,s:L}",
+    "tx_datagrams", stats.tx_datagrams,
+    "tx_frames", stats.tx_frames,
+    "tx_errors", stats.tx_errors,
+    "tx_overruns", stats.tx_overruns,
+    "rx_datagrams", stats.rx_datagrams,
+    "rx_frames", stats.rx_frames,
+    "rx_lost", stats.rx_lost,
+    "rx_out_of_order", stats.rx_out_of_order,
+    "rx_invalid", stats.rx_invalid,
+    "rx_resyncs", stats.rx_resyncs,
+    "rx_rejected", stats.rx_rejected,
+    "can_tx_errors", stats.can_tx_errors
+  );
+}
+
+// Parses (can_id, mask[, data[, data_mask]]) tuple, data mask defaults to
+// all bits of data
+static bool py_candle_device_parse_trigger(PyObject* item, recorder_trigger_t* trigger)
+{
+  Py_buffer data = {0};
+  Py_buffer data_mask = {0};
+  bool res = false;
+
+  memset(trigger, 0, sizeof(recorder_trigger_t));
+
+  if (!PyArg_ParseTuple(item, "II|y*y*;Trigger must be (can_id, mask[, data[, data_mask]]) tuple.",
+      &trigger->can_id, &trigger->mask, &data, &data_mask))
+    return false;
+
+  if (data.len > (Py_ssize_t)sizeof(trigger->data) || (data_mask.buf && data_mask.len != data.len)) {
+    PyErr_Format(PyExc_ValueError, "Trigger data and mask must have the same length of up to 64 bytes.");
+    goto done;
+  }
+
+  if (data.buf) {
+    memcpy(trigger->data, data.buf, data.len);
+    if (data_mask.buf)
+      memcpy(trigger->data_mask, data_mask.buf, data.len);
+    else
+      memset(trigger->data_mask, 0xFF, data.len);
+    trigger->data_len = (uint8_t)data.len;
+  }
+  res = true;
+
+done:
+  if (data.buf)
+    PyBuffer_Release(&data);
+  if (data_mask.buf)
+    PyBuffer_Release(&data_mask);
+  return res;
+}
+
+// Keeps last capacity frames of open channels in memory and writes them to
+// a candump log file when a trigger fires. Times are in seconds
+PyObject* py_candle_device_start_recorder(py_candle_device* self, PyObject* args, PyObject* kwds)
+{
+  recorder_config_t config = {0};
+  unsigned long long capacity = RECORDER_DEFAULT_SIZE;
+  double pre_time = 0;
+  double post_time = 1.0;
+  unsigned long long post_frames = 0;
+  PyObject* triggers = NULL;
+  int on_error = 0;
+
+  static char* kwlist[] = {"path", "capacity", "pre_time", "post_time", "post_frames", "triggers", "on_error", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|KddKOp", kwlist, &config.path, &capacity, &pre_time, &post_time,
+      &post_frames, &triggers, &on_error))
+    return NULL;
+
+  if (self->_recorder)
+    return PyErr_Format(PyExc_RuntimeError, "Recorder is already running.");
+
+  if (!capacity || pre_time < 0 || post_time < 0)
+    return PyErr_Format(PyExc_ValueError, "Capacity must be positive and times not negative.");
+
+  if (capacity > RECORDER_MAX_SIZE)
+    return PyErr_Format(PyExc_ValueError, "Capacity is too large (max %d frames).", RECORDER_MAX_SIZE);
+
+  if (triggers) {
+    PyObject* seq = PySequence_Fast(triggers, "Triggers must be a sequence.");
+    if (!seq)
+      return NULL;
+
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (count > RECORDER_MAX_TRIGGERS) {
+      Py_DECREF(seq);
+      return PyErr_Format(PyExc_ValueError, "Too many triggers (max %d).", RECORDER_MAX_TRIGGERS);
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+      if (!py_candle_device_parse_trigger(PySequence_Fast_GET_ITEM(seq, i), &config.triggers[i])) {
+        Py_DECREF(seq);
+        return NULL;
+      }
+    }
+    config.trigger_count = (uint8_t)count;
+    Py_DECREF(seq);
+  }
+
+  config.capacity = (size_t)capacity;
+  config.pre_us = (uint64_t)(pre_time * 1e6);
+  config.post_us = (uint64_t)(post_time * 1e6);
+  config.post_frames = post_frames;
+  config.trigger_on_error = on_error;
+
+  recorder_t* recorder;
+
+  Py_BEGIN_ALLOW_THREADS
+  recorder = recorder_create(&config);
+  Py_END_ALLOW_THREADS
+
+  if (!recorder)
+    return Py_BuildValue("O", Py_False);
+
+  AcquireSRWLockExclusive(&self->_channels_lock);
+  self->_recorder = recorder;
+  ReleaseSRWLockExclusive(&self->_channels_lock);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+// Pending dump is still written
+PyObject* py_candle_device_stop_recorder(py_candle_device* self, PyObject* Py_UNUSED(ignored))
+{
+  AcquireSRWLockExclusive(&self->_channels_lock);
+  recorder_t* recorder = self->_recorder;
+  self->_recorder = NULL;
+  ReleaseSRWLockExclusive(&self->_channels_lock);
+
+  Py_BEGIN_ALLOW_THREADS
+  recorder_delete(recorder);
+  Py_END_ALLOW_THREADS
+
+  Py_RETURN_NONE;
+}
+
+// Returns False if recorder is already triggered or dumping
+PyObject* py_candle_device_trigger_recorder(py_candle_device* self, PyObject* Py_UNUSED(ignored))
+{
+  if (!self->_recorder)
+    return PyErr_Format(PyExc_RuntimeError, "Recorder is not running.");
+
+  return Py_BuildValue("O", recorder_trigger(self->_recorder) ? Py_True : Py_False);
+}
+
+PyObject* py_candle_device_recorder_stats(py_candle_device* self, PyObject* Py_UNUSED(ignored))
+{
+  static const char* states[] = {"armed", "triggered", "dumping"};
+
+  if (!self->_recorder)
+    return PyErr_Format(PyExc_RuntimeError, "Recorder is not running.");
+
+  recorder_stats_t stats = *recorder_stats(self->_recorder);
+
+  return Py_BuildValue("{s:s,s:K,s:K,s:K,s:K,s:K,s:K}",
+    "state", states[recorder_state(self->_recorder)],
+    "frames", stats.frames,
+    "missed", stats.missed,
+    "triggers", stats.triggers,
+    "dumps", stats.dumps,
+    "dump_errors", stats.dump_errors,
+    "dumped_frames", stats.dumped_frames
+  );
+}
+
 PyMethodDef py_candle_device_methods[] = {
   {"state", (PyCFunction)py_candle_device_state, METH_NOARGS, "Returns candle device state"},
   {"open", (PyCFunction)py_candle_device_open, METH_NOARGS, "Opens device"},
@@ -279,6 +1101,20 @@ PyMethodDef py_candle_device_methods[] = {
   {"channel_count", (PyCFunction)py_candle_device_channel_count, METH_NOARGS, "Returns numbers of available channels"},
   {"channel", (PyCFunction)py_candle_device_channel, METH_VARARGS, "Returns specified device channel"},
   {"timestamp", (PyCFunction)py_candle_device_timestamp, METH_NOARGS, "Returns current device timestamp in us"},
+  {"stats", (PyCFunction)py_candle_device_stats, METH_VARARGS | METH_KEYWORDS, "Returns RX thread performance counters"},
+  {"read_any", (PyCFunction)py_candle_device_read_any, METH_VARARGS | METH_KEYWORDS, "Reads frames from any open channel"},
+  {"start_exporter", (PyCFunction)py_candle_device_start_exporter, METH_VARARGS | METH_KEYWORDS, "Starts Prometheus metrics HTTP server"},
+  {"stop_exporter", (PyCFunction)py_candle_device_stop_exporter, METH_NOARGS, "Stops Prometheus metrics HTTP server"},
+  {"start_publisher", (PyCFunction)py_candle_device_start_publisher, METH_VARARGS | METH_KEYWORDS, "Shares received frames with other processes"},
+  {"stop_publisher", (PyCFunction)py_candle_device_stop_publisher, METH_NOARGS, "Stops sharing frames"},
+  {"start_bridge", (PyCFunction)py_candle_device_start_bridge, METH_VARARGS | METH_KEYWORDS, "Starts CAN over UDP bridge"},
+  {"stop_bridge", (PyCFunction)py_candle_device_stop_bridge, METH_NOARGS, "Stops CAN over UDP bridge"},
+  {"bridge_stats", (PyCFunction)py_candle_device_bridge_stats, METH_NOARGS, "Returns bridge datagram and loss counters"},
+  {"publisher_stats", (PyCFunction)py_candle_device_publisher_stats, METH_NOARGS, "Returns state of attached shared memory readers"},
+  {"start_recorder", (PyCFunction)py_candle_device_start_recorder, METH_VARARGS | METH_KEYWORDS, "Starts flight recorder with triggered dumps"},
+  {"stop_recorder", (PyCFunction)py_candle_device_stop_recorder, METH_NOARGS, "Stops flight recorder"},
+  {"trigger_recorder", (PyCFunction)py_candle_device_trigger_recorder, METH_NOARGS, "Triggers flight recorder dump"},
+  {"recorder_stats", (PyCFunction)py_candle_device_recorder_stats, METH_NOARGS, "Returns flight recorder state and counters"},
   {NULL}  /* Sentinel */
 };
 
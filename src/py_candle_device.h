@@ -6,9 +6,19 @@
 #include <structmember.h>
 #include "candle_api/candle.h"
 #include "py_candle_channel.h"
+#include "stats.h"
+#include "exporter.h"
+#include "shm.h"
+#include "bridge.h"
+#include "recorder.h"
 
 #define CANDLE_MAX_CHANNELS 4
 #define CANDLE_RX_THREAD_INTERVAL 10 // in ms
+#define CANDLE_CLOCK_SYNC_INTERVAL_US 1000000
+// Default size of the shared memory ring of the publisher
+#define CANDLE_PUBLISHER_SIZE 4096
+// Default maximum number of frames returned by read_any
+#define CANDLE_READ_ANY_MAX_FRAMES 64
 
 typedef void* HANDLE;
 
@@ -18,12 +28,44 @@ typedef struct py_candle_device {
   // Candle device handle
   candle_handle _handle;
 
-  // Open channels
+  // Open channels. Lock is held exclusively while a channel is unlinked so
+  // threads other than RX thread can safely read channel counters
   py_candle_channel* _channels[CANDLE_MAX_CHANNELS];
+  SRWLOCK _channels_lock;
 
   // RX thread
   HANDLE _rx_thread;
   bool _rx_thread_stop_req;
+
+  // RX thread counters, baseline of last reset and time of reset
+  candle_device_stats_t _stats;
+  candle_device_stats_t _stats_base;
+  uint64_t _stats_reset_time_us;
+  // Timestamp of the last frame pushed to FIFOs (to detect reordering
+  // beyond RX_REORDER_QUEUE_SIZE)
+  bool _last_timestamp_valid;
+  uint32_t _last_timestamp_us;
+
+  // Host and device clock correlation (host_us - device_us)
+  int64_t _clock_offset_us;
+  uint64_t _clock_sync_time_us;
+
+  // Prometheus exporter and value of its device label
+  exporter_t* _exporter;
+  char _metrics_label[64];
+
+  // Shared memory publisher for other processes. RX thread uses it with
+  // _channels_lock held shared
+  shm_publisher_t* _publisher;
+
+  // CAN over UDP bridge, RX thread uses it with _channels_lock held shared
+  bridge_t* _bridge;
+
+  // Flight recorder, RX thread uses it with _channels_lock held shared
+  recorder_t* _recorder;
+
+  // Open channel read_any drains first, advanced on every call
+  size_t _read_any_start;
 } py_candle_device;
 
 extern PyTypeObject py_candle_device_type;
@@ -31,4 +73,13 @@ extern PyTypeObject py_candle_device_type;
 // Called by the channel destructor
 void py_candle_device_close_channel(py_candle_device* self, uint8_t ch);
 
+// Sends frame on the open channel given by frame channel, never takes the GIL
+bool py_candle_device_send_frame(void* ctx, const void* item);
+
+// Clock correlation. Sync is done on open and refreshed by the RX thread
+// when older than CANDLE_CLOCK_SYNC_INTERVAL_US to compensate drift
+bool py_candle_device_sync_clock(py_candle_device* self);
+uint64_t py_candle_device_host_time_us(py_candle_device* self, uint32_t device_us);
+uint32_t py_candle_device_device_time_us(py_candle_device* self, uint64_t host_us);
+
 #endif
@@ -2,7 +2,13 @@
 #include <Python.h>
 #include "py_candle_channel.h"
 #include "py_candle_device.h"
+#include "py_candle_dbc.h"
+#include "py_candle_frame.h"
+#include "py_candle_subscription.h"
+#include "py_candle_send.h"
+#include "py_candle_shared.h"
 #include "candle_api/candle.h"
+#include "timing.h"
 
 static PyObject* py_candle_driver_list_devices(PyObject* self, PyObject* args)
 {
@@ -31,8 +37,96 @@ static PyObject* py_candle_driver_list_devices(PyObject* self, PyObject* args)
     return Py_BuildValue("[]");
 }
 
+static PyObject* py_candle_driver_host_timestamp(PyObject* self, PyObject* Py_UNUSED(ignored))
+{
+  return Py_BuildValue("K", (unsigned long long)timing_now_us());
+}
+
+// Waits until any of the channels has data in its FIFO or priority lane,
+// returns list of ready channels (empty on timeout)
+static PyObject* py_candle_driver_select(PyObject* self, PyObject* args, PyObject* kwds)
+{
+  PyObject* sequence;
+  uint32_t timeout_ms = 0;
+  py_candle_channel* channels[CANDLE_WAIT_MAX_CHANNELS];
+  bool ready[CANDLE_WAIT_MAX_CHANNELS];
+  size_t ready_count;
+
+  static char* kwlist[] = {"channels", "timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O&", kwlist, &sequence, py_candle_timeout_converter, &timeout_ms))
+    return NULL;
+
+  // Fast sequence keeps channels alive while the GIL is released
+  PyObject* fast = PySequence_Fast(sequence, "Channels must be a sequence.");
+  if (!fast)
+    return NULL;
+
+  Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+  Py_ssize_t count = 0;
+  DWORD error = 0;
+
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    PyObject* item = PySequence_Fast_GET_ITEM(fast, i);
+    if (!PyObject_TypeCheck(item, &py_candle_channel_type)) {
+      Py_DECREF(fast);
+      return PyErr_Format(PyExc_TypeError, "Item %zd is not a channel.", i);
+    }
+
+    // Wait rejects duplicate handles, a channel is listed once
+    Py_ssize_t j = 0;
+    while (j < count && channels[j] != (py_candle_channel*)item)
+      j++;
+    if (j < count)
+      continue;
+
+    if (count == CANDLE_WAIT_MAX_CHANNELS) {
+      Py_DECREF(fast);
+      return PyErr_Format(PyExc_ValueError, "At most %d channels can be selected.", CANDLE_WAIT_MAX_CHANNELS);
+    }
+    channels[count++] = (py_candle_channel*)item;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  ready_count = count ? py_candle_channel_wait_any(channels, count, timeout_ms, true, ready) : 0;
+  if (ready_count == CANDLE_WAIT_FAILED)
+    error = GetLastError();
+  Py_END_ALLOW_THREADS
+
+  if (ready_count == CANDLE_WAIT_FAILED) {
+    Py_DECREF(fast);
+    return PyErr_SetFromWindowsErr((int)error);
+  }
+
+  PyObject* result = PyList_New(ready_count);
+  if (result) {
+    Py_ssize_t j = 0;
+    for (Py_ssize_t i = 0; i < count && j < (Py_ssize_t)ready_count; ++i) {
+      if (ready[i]) {
+        Py_INCREF(channels[i]);
+        PyList_SET_ITEM(result, j++, (PyObject*)channels[i]);
+      }
+    }
+  }
+
+  Py_DECREF(fast);
+
+  return result;
+}
+
+// Registered with atexit, which runs before the interpreter is finalized
+static PyObject* py_candle_driver_shutdown(PyObject* self, PyObject* Py_UNUSED(ignored))
+{
+  py_candle_channel_stop_dispatchers();
+
+  Py_RETURN_NONE;
+}
+
 static PyMethodDef module_methods[] = {
   {"list_devices", py_candle_driver_list_devices, METH_VARARGS, "Lists all available candle devices"},
+  {"host_timestamp", py_candle_driver_host_timestamp, METH_NOARGS, "Returns host monotonic timestamp in us"},
+  {"select", (PyCFunction)py_candle_driver_select, METH_VARARGS | METH_KEYWORDS, "Waits until any of the channels has data"},
+  {"_shutdown", py_candle_driver_shutdown, METH_NOARGS, "Stops background threads that run python code"},
   {NULL, NULL, 0, NULL}
 };
 
@@ -53,6 +147,21 @@ PyMODINIT_FUNC PyInit_candle_driver(void)
   if (PyType_Ready(&py_candle_channel_type) < 0)
     return NULL;
 
+  if (PyType_Ready(&py_candle_dbc_type) < 0)
+    return NULL;
+
+  if (PyType_Ready(&py_candle_frame_type) < 0)
+    return NULL;
+
+  if (PyType_Ready(&py_candle_subscription_type) < 0)
+    return NULL;
+
+  if (PyType_Ready(&py_candle_shared_reader_type) < 0)
+    return NULL;
+
+  if (PyType_Ready(&py_candle_send_handle_type) < 0)
+    return NULL;
+
   PyObject* m = PyModule_Create(&py_candle_driver);
   if (m == NULL)
     return NULL;
@@ -63,12 +172,44 @@ PyMODINIT_FUNC PyInit_candle_driver(void)
   Py_INCREF(&py_candle_channel_type);
   PyModule_AddObject(m, "channel", (PyObject*)&py_candle_channel_type);
 
+  Py_INCREF(&py_candle_dbc_type);
+  PyModule_AddObject(m, "dbc", (PyObject*)&py_candle_dbc_type);
+
+  Py_INCREF(&py_candle_frame_type);
+  PyModule_AddObject(m, "Frame", (PyObject*)&py_candle_frame_type);
+
+  Py_INCREF(&py_candle_subscription_type);
+  PyModule_AddObject(m, "Subscription", (PyObject*)&py_candle_subscription_type);
+
+  Py_INCREF(&py_candle_shared_reader_type);
+  PyModule_AddObject(m, "SharedReader", (PyObject*)&py_candle_shared_reader_type);
+
+  Py_INCREF(&py_candle_send_handle_type);
+  PyModule_AddObject(m, "SendHandle", (PyObject*)&py_candle_send_handle_type);
+
+  // Dispatcher threads must be joined while they can still take the GIL
+  PyObject* atexit = PyImport_ImportModule("atexit");
+  PyObject* shutdown = PyObject_GetAttrString(m, "_shutdown");
+  PyObject* res = atexit && shutdown ? PyObject_CallMethod(atexit, "register", "O", shutdown) : NULL;
+  Py_XDECREF(atexit);
+  Py_XDECREF(shutdown);
+  if (!res) {
+    Py_DECREF(m);
+    return NULL;
+  }
+  Py_DECREF(res);
+
+  // Record size of buffers filled by channel.readinto()
+  PyModule_AddIntConstant(m, "CANDLE_FRAME_SIZE", sizeof(candle_frame_t));
+
   PyModule_AddIntConstant(m, "CANDLE_MODE_NORMAL", CANDLE_MODE_NORMAL);
   PyModule_AddIntConstant(m, "CANDLE_MODE_LISTEN_ONLY", CANDLE_MODE_LISTEN_ONLY);
   PyModule_AddIntConstant(m, "CANDLE_MODE_LOOP_BACK", CANDLE_MODE_LOOP_BACK);
   PyModule_AddIntConstant(m, "CANDLE_MODE_TRIPLE_SAMPLE", CANDLE_MODE_TRIPLE_SAMPLE);
   PyModule_AddIntConstant(m, "CANDLE_MODE_ONE_SHOT", CANDLE_MODE_ONE_SHOT);
   PyModule_AddIntConstant(m, "CANDLE_MODE_HW_TIMESTAMP", CANDLE_MODE_HW_TIMESTAMP);
+  PyModule_AddIntConstant(m, "CANDLE_MODE_FD", CANDLE_MODE_FD);
+  PyModule_AddIntConstant(m, "CANDLE_MODE_BERR_REPORTING", CANDLE_MODE_BERR_REPORTING);
 
   PyModule_AddIntConstant(m, "CANDLE_DEVSTATE_AVAIL", CANDLE_DEVSTATE_AVAIL);
   PyModule_AddIntConstant(m, "CANDLE_DEVSTATE_INUSE", CANDLE_DEVSTATE_INUSE);
@@ -77,12 +218,26 @@ PyMODINIT_FUNC PyInit_candle_driver(void)
   PyModule_AddIntConstant(m, "CANDLE_ID_RTR", CANDLE_ID_RTR);
   PyModule_AddIntConstant(m, "CANDLE_ID_ERR", CANDLE_ID_ERR);
 
+  PyModule_AddIntConstant(m, "CANDLE_FLAG_OVERFLOW", CANDLE_FLAG_OVERFLOW);
+  PyModule_AddIntConstant(m, "CANDLE_FLAG_FD", CANDLE_FLAG_FD);
+  PyModule_AddIntConstant(m, "CANDLE_FLAG_BRS", CANDLE_FLAG_BRS);
+  PyModule_AddIntConstant(m, "CANDLE_FLAG_ESI", CANDLE_FLAG_ESI);
+
   PyModule_AddIntConstant(m, "CANDLE_FRAMETYPE_UNKNOWN", CANDLE_FRAMETYPE_UNKNOWN);
   PyModule_AddIntConstant(m, "CANDLE_FRAMETYPE_RECEIVE", CANDLE_FRAMETYPE_RECEIVE);
   PyModule_AddIntConstant(m, "CANDLE_FRAMETYPE_ECHO", CANDLE_FRAMETYPE_ECHO);
   PyModule_AddIntConstant(m, "CANDLE_FRAMETYPE_ERROR", CANDLE_FRAMETYPE_ERROR);
   PyModule_AddIntConstant(m, "CANDLE_FRAMETYPE_TIMESTAMP_OVFL", CANDLE_FRAMETYPE_TIMESTAMP_OVFL);
 
+  PyModule_AddIntConstant(m, "CAN_STATE_ERROR_ACTIVE", CAN_STATE_ERROR_ACTIVE);
+  PyModule_AddIntConstant(m, "CAN_STATE_ERROR_WARNING", CAN_STATE_ERROR_WARNING);
+  PyModule_AddIntConstant(m, "CAN_STATE_ERROR_PASSIVE", CAN_STATE_ERROR_PASSIVE);
+  PyModule_AddIntConstant(m, "CAN_STATE_BUS_OFF", CAN_STATE_BUS_OFF);
+
+  PyModule_AddIntConstant(m, "UAVCAN_TRANSFER_MESSAGE", UAVCAN_TRANSFER_MESSAGE);
+  PyModule_AddIntConstant(m, "UAVCAN_TRANSFER_REQUEST", UAVCAN_TRANSFER_REQUEST);
+  PyModule_AddIntConstant(m, "UAVCAN_TRANSFER_RESPONSE", UAVCAN_TRANSFER_RESPONSE);
+
   PyModule_AddIntConstant(m, "CANDLE_ERR_OK", CANDLE_ERR_OK);
   PyModule_AddIntConstant(m, "CANDLE_ERR_CREATE_FILE", CANDLE_ERR_CREATE_FILE);
   PyModule_AddIntConstant(m, "CANDLE_ERR_WINUSB_INITIALIZE", CANDLE_ERR_WINUSB_INITIALIZE);
@@ -113,6 +268,9 @@ PyMODINIT_FUNC PyInit_candle_driver(void)
   PyModule_AddIntConstant(m, "CANDLE_ERR_DEV_OUT_OF_RANGE", CANDLE_ERR_DEV_OUT_OF_RANGE);
   PyModule_AddIntConstant(m, "CANDLE_ERR_GET_TIMESTAMP", CANDLE_ERR_GET_TIMESTAMP);
   PyModule_AddIntConstant(m, "CANDLE_ERR_SET_PIPE_RAW_IO", CANDLE_ERR_SET_PIPE_RAW_IO);
+  PyModule_AddIntConstant(m, "CANDLE_ERR_SET_DATA_BITTIMING", CANDLE_ERR_SET_DATA_BITTIMING);
+  PyModule_AddIntConstant(m, "CANDLE_ERR_SET_BERR", CANDLE_ERR_SET_BERR);
+  PyModule_AddIntConstant(m, "CANDLE_ERR_CHANNEL_OUT_OF_RANGE", CANDLE_ERR_CHANNEL_OUT_OF_RANGE);
 
   return m;
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "py_candle_frame.h"
+#include <stdio.h>
+
+// Only accessed with the GIL held
+static py_candle_frame* frame_freelist[CANDLE_FRAME_FREELIST_SIZE];
+static int frame_freelist_count = 0;
+
+PyObject* py_candle_frame_from(const candle_frame_t* frame)
+{
+  py_candle_frame* self;
+
+  if (frame_freelist_count) {
+    self = frame_freelist[--frame_freelist_count];
+    PyObject_Init((PyObject*)self, &py_candle_frame_type);
+  } else {
+    self = PyObject_New(py_candle_frame, &py_candle_frame_type);
+    if (!self)
+      return NULL;
+  }
+
+  self->_frame = *frame;
+
+  return (PyObject*)self;
+}
+
+void py_candle_frame_dealloc(py_candle_frame* self)
+{
+  if (frame_freelist_count < CANDLE_FRAME_FREELIST_SIZE) {
+    frame_freelist[frame_freelist_count++] = self;
+    return;
+  }
+
+  PyObject_Free(self);
+}
+
+static PyObject* py_candle_frame_get_type(py_candle_frame* self, void* closure)
+{
+  return PyLong_FromUnsignedLong(candle_frame_type(&self->_frame));
+}
+
+static PyObject* py_candle_frame_get_id(py_candle_frame* self, void* closure)
+{
+  return PyLong_FromUnsignedLong(candle_frame_id(&self->_frame));
+}
+
+static PyObject* py_candle_frame_get_data(py_candle_frame* self, void* closure)
+{
+  return PyBytes_FromStringAndSize((const char*)self->_frame.data, candle_frame_size(&self->_frame));
+}
+
+static PyObject* py_candle_frame_get_extended(py_candle_frame* self, void* closure)
+{
+  return PyBool_FromLong(candle_frame_is_extended_id(&self->_frame));
+}
+
+static PyObject* py_candle_frame_get_timestamp(py_candle_frame* self, void* closure)
+{
+  return PyLong_FromUnsignedLong(candle_frame_timestamp_us(&self->_frame));
+}
+
+static PyObject* py_candle_frame_get_host_timestamp(py_candle_frame* self, void* closure)
+{
+  return PyLong_FromUnsignedLongLong(self->_frame.host_timestamp_us);
+}
+
+static PyObject* py_candle_frame_get_dlc(py_candle_frame* self, void* closure)
+{
+  return PyLong_FromUnsignedLong(self->_frame.can_dlc);
+}
+
+static PyObject* py_candle_frame_get_flags(py_candle_frame* self, void* closure)
+{
+  return PyLong_FromUnsignedLong(self->_frame.flags);
+}
+
+static PyObject* py_candle_frame_get_channel(py_candle_frame* self, void* closure)
+{
+  return PyLong_FromUnsignedLong(self->_frame.channel);
+}
+
+static PyObject* py_candle_frame_get_rtr(py_candle_frame* self, void* closure)
+{
+  return PyBool_FromLong(candle_frame_is_rtr(&self->_frame));
+}
+
+static PyObject* py_candle_frame_get_fd(py_candle_frame* self, void* closure)
+{
+  return PyBool_FromLong(candle_frame_is_fd(&self->_frame));
+}
+
+// Items in the order of the tuple returned by older read()
+static PyObject* py_candle_frame_item(py_candle_frame* self, Py_ssize_t i)
+{
+  switch (i) {
+    case 0: return py_candle_frame_get_type(self, NULL);
+    case 1: return py_candle_frame_get_id(self, NULL);
+    case 2: return py_candle_frame_get_data(self, NULL);
+    case 3: return py_candle_frame_get_extended(self, NULL);
+    case 4: return py_candle_frame_get_timestamp(self, NULL);
+  }
+
+  PyErr_SetString(PyExc_IndexError, "Frame index out of range");
+  return NULL;
+}
+
+static Py_ssize_t py_candle_frame_length(py_candle_frame* self)
+{
+  return CANDLE_FRAME_TUPLE_SIZE;
+}
+
+// Exposes frame data without copying
+static int py_candle_frame_getbuffer(py_candle_frame* self, Py_buffer* view, int flags)
+{
+  return PyBuffer_FillInfo(view, (PyObject*)self, self->_frame.data, candle_frame_size(&self->_frame), 1, flags);
+}
+
+static PyObject* py_candle_frame_repr(py_candle_frame* self)
+{
+  char repr[3*sizeof(self->_frame.data) + 64];
+  uint8_t size = candle_frame_size(&self->_frame);
+  int len;
+
+  len = snprintf(repr, sizeof(repr), "Frame(id=0x%lx%s, data=[",
+    (unsigned long)candle_frame_id(&self->_frame),
+    candle_frame_is_extended_id(&self->_frame) ? "x" : "");
+
+  for (uint8_t i = 0; i < size; ++i)
+    len += snprintf(repr + len, sizeof(repr) - len, i ? " %02X" : "%02X", self->_frame.data[i]);
+
+  snprintf(repr + len, sizeof(repr) - len, "], timestamp=%lu)", (unsigned long)candle_frame_timestamp_us(&self->_frame));
+
+  return PyUnicode_FromString(repr);
+}
+
+PyGetSetDef py_candle_frame_getset[] = {
+  {"type", (getter)py_candle_frame_get_type, NULL, "Frame type (CANDLE_FRAMETYPE_*)", NULL},
+  {"id", (getter)py_candle_frame_get_id, NULL, "CAN id without flags", NULL},
+  {"data", (getter)py_candle_frame_get_data, NULL, "Frame data as bytes, memoryview(frame) avoids the copy", NULL},
+  {"extended", (getter)py_candle_frame_get_extended, NULL, "True for 29 bit id", NULL},
+  {"timestamp", (getter)py_candle_frame_get_timestamp, NULL, "Device timestamp in us", NULL},
+  {"host_timestamp", (getter)py_candle_frame_get_host_timestamp, NULL, "Host time of USB transfer completion in us", NULL},
+  {"dlc", (getter)py_candle_frame_get_dlc, NULL, "Data length code", NULL},
+  {"flags", (getter)py_candle_frame_get_flags, NULL, "Frame flags (CANDLE_FLAG_*)", NULL},
+  {"channel", (getter)py_candle_frame_get_channel, NULL, "Device channel number", NULL},
+  {"rtr", (getter)py_candle_frame_get_rtr, NULL, "True for remote request frame", NULL},
+  {"fd", (getter)py_candle_frame_get_fd, NULL, "True for CAN FD frame", NULL},
+  {NULL}  /* Sentinel */
+};
+
+PySequenceMethods py_candle_frame_sequence = {
+  .sq_length = (lenfunc)py_candle_frame_length,
+  .sq_item = (ssizeargfunc)py_candle_frame_item,
+};
+
+PyBufferProcs py_candle_frame_buffer = {
+  .bf_getbuffer = (getbufferproc)py_candle_frame_getbuffer,
+};
+
+PyTypeObject py_candle_frame_type = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "candle_driver.Frame",
+  .tp_doc = "Received CAN frame, unpacks as (type, id, data, extended, timestamp)",
+  .tp_basicsize = sizeof(py_candle_frame),
+  .tp_itemsize = 0,
+  // Not a base type, freelist relies on all instances having the same size
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_dealloc = (destructor)py_candle_frame_dealloc,
+  .tp_repr = (reprfunc)py_candle_frame_repr,
+  .tp_as_sequence = &py_candle_frame_sequence,
+  .tp_as_buffer = &py_candle_frame_buffer,
+  .tp_getset = py_candle_frame_getset,
+};
@@ -0,0 +1,28 @@
+#ifndef _PY_CANDLE_FRAME_H_
+#define _PY_CANDLE_FRAME_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include "candle_api/candle.h"
+
+// Released frames are kept for reuse instead of being freed
+#define CANDLE_FRAME_FREELIST_SIZE 256
+
+// Number of items when unpacked like the tuple returned by older read()
+// (type, id, data, extended, timestamp)
+#define CANDLE_FRAME_TUPLE_SIZE 5
+
+typedef struct py_candle_frame {
+  PyObject_HEAD
+
+  // Frame is stored inline, data is exposed through the buffer protocol
+  candle_frame_t _frame;
+} py_candle_frame;
+
+extern PyTypeObject py_candle_frame_type;
+
+// Returns new frame object holding a copy of frame
+PyObject* py_candle_frame_from(const candle_frame_t* frame);
+
+#endif
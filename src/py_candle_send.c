@@ -0,0 +1,183 @@
+#include "py_candle_send.h"
+#include "py_candle_channel.h"
+#include "timing.h"
+
+static const char* py_candle_send_state_names[] = {"pending", "sent", "error", "stale", "timeout", "cancelled"};
+
+py_candle_send_handle* py_candle_send_handle_new(py_candle_channel* channel)
+{
+  py_candle_send_handle* self = PyObject_New(py_candle_send_handle, &py_candle_send_handle_type);
+  if (!self)
+    return NULL;
+
+  self->_state = CANDLE_SEND_PENDING;
+  self->_timestamp_us = 0;
+  self->_channel = channel;
+  self->_next = NULL;
+  self->_future = NULL;
+
+  return self;
+}
+
+void py_candle_send_handle_dealloc(py_candle_send_handle* self)
+{
+  Py_XDECREF(self->_future);
+  PyObject_Free(self);
+}
+
+void py_candle_send_handle_complete(py_candle_send_handle* self, txq_status_t status, uint32_t timestamp_us)
+{
+  self->_timestamp_us = timestamp_us;
+  InterlockedExchange(&self->_state, CANDLE_SEND_SENT + status);
+  WakeByAddressAll((void*)&self->_state);
+}
+
+PyObject* py_candle_send_handle_value(py_candle_send_handle* self)
+{
+  if (self->_state != CANDLE_SEND_SENT)
+    return Py_BuildValue("O", Py_False);
+
+  return PyLong_FromUnsignedLong(self->_timestamp_us);
+}
+
+PyObject* py_candle_send_handle_done(py_candle_send_handle* self, PyObject* Py_UNUSED(ignored))
+{
+  return Py_BuildValue("O", self->_state != CANDLE_SEND_PENDING ? Py_True : Py_False);
+}
+
+// Waits for completion, returns echo timestamp or False if the frame was not
+// sent. Timeout in ms, None waits forever
+PyObject* py_candle_send_handle_result(py_candle_send_handle* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t timeout_ms = INFINITE;
+
+  static char* kwlist[] = {"timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O&", kwlist, py_candle_timeout_converter, &timeout_ms))
+    return NULL;
+
+  Py_BEGIN_ALLOW_THREADS
+  LONG pending = CANDLE_SEND_PENDING;
+  uint64_t deadline_us = timing_now_us() + (uint64_t)timeout_ms*1000;
+
+  // Wakeups may be spurious, state decides
+  while (self->_state == CANDLE_SEND_PENDING) {
+    DWORD wait_ms = INFINITE;
+
+    if (timeout_ms != INFINITE) {
+      uint64_t now = timing_now_us();
+      if (now >= deadline_us)
+        break;
+      wait_ms = (DWORD)((deadline_us - now + 999) / 1000);
+    }
+
+    WaitOnAddress(&self->_state, &pending, sizeof(pending), wait_ms);
+  }
+  Py_END_ALLOW_THREADS
+
+  if (self->_state == CANDLE_SEND_PENDING)
+    return PyErr_Format(PyExc_TimeoutError, "CAN write timeout.");
+
+  return py_candle_send_handle_value(self);
+}
+
+// Returns future of the running loop resolved like result()
+static PyObject* py_candle_send_handle_future(py_candle_send_handle* self)
+{
+  if (self->_future) {
+    Py_INCREF(self->_future);
+    return self->_future;
+  }
+
+  PyObject* asyncio = PyImport_ImportModule("asyncio");
+  if (!asyncio)
+    return NULL;
+
+  PyObject* loop = PyObject_CallMethod(asyncio, "get_running_loop", NULL);
+  Py_DECREF(asyncio);
+  if (!loop)
+    return NULL;
+
+  PyObject* future = PyObject_CallMethod(loop, "create_future", NULL);
+  PyObject* res = NULL;
+
+  if (future) {
+    if (self->_state != CANDLE_SEND_PENDING) {
+      PyObject* value = py_candle_send_handle_value(self);
+      if (value) {
+        res = PyObject_CallMethod(future, "set_result", "O", value);
+        Py_DECREF(value);
+      }
+    } else if (!py_candle_channel_send_watch(self->_channel, loop)) {
+      // Pending handle is still held by its channel
+      Py_INCREF(future);
+      self->_future = future;
+      res = Py_None;
+      Py_INCREF(res);
+    }
+  }
+
+  Py_DECREF(loop);
+
+  if (!res) {
+    Py_XDECREF(future);
+    return NULL;
+  }
+
+  Py_DECREF(res);
+  return future;
+}
+
+PyObject* py_candle_send_handle_await(py_candle_send_handle* self)
+{
+  PyObject* future = py_candle_send_handle_future(self);
+  if (!future)
+    return NULL;
+
+  PyObject* iter = PyObject_CallMethod(future, "__await__", NULL);
+  Py_DECREF(future);
+
+  return iter;
+}
+
+static PyObject* py_candle_send_handle_get_status(py_candle_send_handle* self, void* closure)
+{
+  return PyUnicode_FromString(py_candle_send_state_names[self->_state]);
+}
+
+static PyObject* py_candle_send_handle_get_timestamp(py_candle_send_handle* self, void* closure)
+{
+  if (self->_state != CANDLE_SEND_SENT)
+    Py_RETURN_NONE;
+
+  return PyLong_FromUnsignedLong(self->_timestamp_us);
+}
+
+PyGetSetDef py_candle_send_handle_getset[] = {
+  {"status", (getter)py_candle_send_handle_get_status, NULL, "pending, sent, error, stale, timeout or cancelled", NULL},
+  {"timestamp", (getter)py_candle_send_handle_get_timestamp, NULL, "Device timestamp of the echo in us, None until sent", NULL},
+  {NULL}  /* Sentinel */
+};
+
+PyMethodDef py_candle_send_handle_methods[] = {
+  {"done", (PyCFunction)py_candle_send_handle_done, METH_NOARGS, "Returns True once the frame was sent or dropped"},
+  {"result", (PyCFunction)py_candle_send_handle_result, METH_VARARGS | METH_KEYWORDS, "Waits for echo timestamp, False if not sent"},
+  {NULL}  /* Sentinel */
+};
+
+PyAsyncMethods py_candle_send_handle_async = {
+  .am_await = (unaryfunc)py_candle_send_handle_await,
+};
+
+PyTypeObject py_candle_send_handle_type = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "candle_driver.SendHandle",
+  .tp_doc = "Completion of channel.send_async(), awaitable",
+  .tp_basicsize = sizeof(py_candle_send_handle),
+  .tp_itemsize = 0,
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_dealloc = (destructor)py_candle_send_handle_dealloc,
+  .tp_as_async = &py_candle_send_handle_async,
+  .tp_getset = py_candle_send_handle_getset,
+  .tp_methods = py_candle_send_handle_methods,
+};
@@ -0,0 +1,52 @@
+#ifndef _PY_CANDLE_SEND_H_
+#define _PY_CANDLE_SEND_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include <windows.h>
+#include "candle_api/candle.h"
+#include "txq.h"
+
+// Handle states, outcomes follow txq_status_t
+typedef enum {
+  CANDLE_SEND_PENDING,
+  CANDLE_SEND_SENT,
+  CANDLE_SEND_ERROR,
+  CANDLE_SEND_STALE,
+  CANDLE_SEND_TIMEOUT,
+  CANDLE_SEND_CANCELLED,
+} candle_send_state_t;
+
+struct py_candle_channel;
+
+// Completion of channel.send_async(). The TX queue completes it without the
+// GIL, waiters of result() sleep on _state with WaitOnAddress
+typedef struct py_candle_send_handle {
+  PyObject_HEAD
+
+  // Timestamp is written before _state leaves CANDLE_SEND_PENDING
+  volatile LONG _state;
+  uint32_t _timestamp_us;
+
+  // Set while the channel holds a reference, which it drops after the
+  // completed handle was taken from its done list (linked by _next)
+  struct py_candle_channel* _channel;
+  struct py_candle_send_handle* _next;
+
+  // Future of await, resolved by the channel's event loop reader
+  PyObject* _future;
+} py_candle_send_handle;
+
+extern PyTypeObject py_candle_send_handle_type;
+
+// Returns new pending handle of channel
+py_candle_send_handle* py_candle_send_handle_new(struct py_candle_channel* channel);
+
+// Stores outcome and wakes waiters, called without the GIL
+void py_candle_send_handle_complete(py_candle_send_handle* self, txq_status_t status, uint32_t timestamp_us);
+
+// Echo timestamp in us if the frame was sent, False otherwise
+PyObject* py_candle_send_handle_value(py_candle_send_handle* self);
+
+#endif
@@ -0,0 +1,247 @@
+#include "py_candle_shared.h"
+#include "py_candle_channel.h"
+#include "py_candle_frame.h"
+
+void py_candle_shared_reader_dealloc(py_candle_shared_reader* self)
+{
+  shm_reader_close(self->_reader);
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+PyObject* py_candle_shared_reader_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  const char* name;
+
+  py_candle_shared_reader* self = (py_candle_shared_reader*)type->tp_alloc(type, 0);
+
+  if (!self)
+    return NULL;
+
+  if (!PyArg_ParseTuple(args, "s", &name))
+  {
+    type->tp_free((PyObject*)self);
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  self->_reader = shm_reader_open(name, sizeof(candle_frame_t));
+  Py_END_ALLOW_THREADS
+
+  if (!self->_reader)
+  {
+    type->tp_free((PyObject*)self);
+    return PyErr_Format(PyExc_ConnectionError, "Unable to attach to publisher %s.", name);
+  }
+
+  InitializeSRWLock(&self->_lock);
+
+  return (PyObject*)self;
+}
+
+int py_candle_shared_reader_init(py_candle_shared_reader *self, PyObject *args, PyObject *kwds)
+{
+  return 0;
+}
+
+static bool py_candle_shared_reader_check(py_candle_shared_reader* self)
+{
+  if (!self->_reader) {
+    PyErr_Format(PyExc_ValueError, "Reader is closed.");
+    return false;
+  }
+
+  return true;
+}
+
+static size_t py_candle_shared_reader_read_frames(py_candle_shared_reader* self, candle_frame_t* frames, size_t max_count, uint32_t timeout_ms)
+{
+  size_t count = 0;
+
+  Py_BEGIN_ALLOW_THREADS
+  AcquireSRWLockExclusive(&self->_lock);
+  // May have been closed by another thread meanwhile
+  if (self->_reader)
+    count = shm_reader_read(self->_reader, frames, max_count, timeout_ms);
+  ReleaseSRWLockExclusive(&self->_lock);
+  Py_END_ALLOW_THREADS
+
+  return count;
+}
+
+PyObject* py_candle_shared_reader_read(py_candle_shared_reader* self, PyObject* args)
+{
+  uint32_t timeout_ms = 0;
+  candle_frame_t frame;
+
+  if (!PyArg_ParseTuple(args, "|O&", py_candle_timeout_converter, &timeout_ms))
+    return NULL;
+
+  if (!py_candle_shared_reader_check(self))
+    return NULL;
+
+  if (!py_candle_shared_reader_read_frames(self, &frame, 1, timeout_ms))
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  return py_candle_frame_from(&frame);
+}
+
+// Returns list of all frames available up to max_frames
+PyObject* py_candle_shared_reader_read_many(py_candle_shared_reader* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t max_frames = CANDLE_SHARED_BATCH_MAX;
+  uint32_t timeout_ms = 0;
+  candle_frame_t frames[CANDLE_SHARED_BATCH_MAX];
+
+  static char* kwlist[] = {"max_frames", "timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|IO&", kwlist, &max_frames, py_candle_timeout_converter, &timeout_ms))
+    return NULL;
+
+  if (!py_candle_shared_reader_check(self))
+    return NULL;
+
+  if (!max_frames || max_frames > CANDLE_SHARED_BATCH_MAX)
+    return PyErr_Format(PyExc_ValueError, "max_frames must be 1 to %u.", CANDLE_SHARED_BATCH_MAX);
+
+  size_t count = py_candle_shared_reader_read_frames(self, frames, max_frames, timeout_ms);
+  if (!count)
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  PyObject* res = PyList_New(count);
+  for (size_t i = 0; res && i < count; ++i) {
+    PyObject* frame = py_candle_frame_from(&frames[i]);
+    if (!frame) {
+      Py_CLEAR(res);
+      break;
+    }
+    PyList_SET_ITEM(res, i, frame);
+  }
+
+  return res;
+}
+
+// Reads frames into writable buffer like channel.readinto()
+PyObject* py_candle_shared_reader_readinto(py_candle_shared_reader* self, PyObject* args, PyObject* kwds)
+{
+  Py_buffer view;
+  uint32_t timeout_ms = 0;
+
+  static char* kwlist[] = {"buffer", "timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "w*|O&", kwlist, &view, py_candle_timeout_converter, &timeout_ms))
+    return NULL;
+
+  size_t max_frames = view.len / sizeof(candle_frame_t);
+  if (!max_frames || !py_candle_shared_reader_check(self)) {
+    PyBuffer_Release(&view);
+    if (PyErr_Occurred())
+      return NULL;
+    return PyErr_Format(PyExc_ValueError, "Buffer is smaller than one frame (%zu bytes).", sizeof(candle_frame_t));
+  }
+
+  size_t count = py_candle_shared_reader_read_frames(self, view.buf, max_frames, timeout_ms);
+  PyBuffer_Release(&view);
+
+  if (!count)
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  return PyLong_FromSize_t(count);
+}
+
+// Queues frame for transmission by the publisher on given device channel
+PyObject* py_candle_shared_reader_write(py_candle_shared_reader* self, PyObject* args)
+{
+  candle_frame_t frame;
+  uint8_t ch;
+  uint32_t can_id;
+  uint32_t flags = 0;
+  const uint8_t* buf;
+  Py_ssize_t len;
+
+  if (!PyArg_ParseTuple(args, "bky#|k", &ch, &can_id, &buf, &len, &flags))
+    return Py_BuildValue("O", Py_False);
+
+  if (!py_candle_shared_reader_check(self))
+    return NULL;
+
+  if (!py_candle_channel_fill_frame(&frame, can_id, buf, len, flags))
+    return NULL;
+
+  frame.channel = ch;
+
+  if (!shm_reader_send(self->_reader, &frame))
+    return Py_BuildValue("O", Py_False);
+
+  return Py_BuildValue("O", Py_True);
+}
+
+PyObject* py_candle_shared_reader_close(py_candle_shared_reader* self, PyObject* Py_UNUSED(ignored))
+{
+  // Wait for reads in progress with the GIL released, then close with both
+  // held so neither reads nor other methods see a closed reader
+  Py_BEGIN_ALLOW_THREADS
+  AcquireSRWLockExclusive(&self->_lock);
+  Py_END_ALLOW_THREADS
+
+  shm_reader_close(self->_reader);
+  self->_reader = NULL;
+  ReleaseSRWLockExclusive(&self->_lock);
+
+  Py_RETURN_NONE;
+}
+
+static PyObject* py_candle_shared_reader_get_dropped(py_candle_shared_reader* self, void* closure)
+{
+  if (!py_candle_shared_reader_check(self))
+    return NULL;
+
+  return PyLong_FromUnsignedLongLong(shm_reader_dropped(self->_reader));
+}
+
+static PyObject* py_candle_shared_reader_get_pending(py_candle_shared_reader* self, void* closure)
+{
+  if (!py_candle_shared_reader_check(self))
+    return NULL;
+
+  return PyLong_FromLongLong(shm_reader_pending(self->_reader));
+}
+
+static PyObject* py_candle_shared_reader_get_connected(py_candle_shared_reader* self, void* closure)
+{
+  return PyBool_FromLong(self->_reader && shm_reader_connected(self->_reader));
+}
+
+PyMemberDef py_candle_shared_reader_members[] = {
+  {NULL}  /* Sentinel */
+};
+
+PyGetSetDef py_candle_shared_reader_getset[] = {
+  {"dropped", (getter)py_candle_shared_reader_get_dropped, NULL, "Frames overwritten before this reader read them", NULL},
+  {"pending", (getter)py_candle_shared_reader_get_pending, NULL, "Frames published but not read yet", NULL},
+  {"connected", (getter)py_candle_shared_reader_get_connected, NULL, "False once the publisher has stopped", NULL},
+  {NULL}  /* Sentinel */
+};
+
+PyMethodDef py_candle_shared_reader_methods[] = {
+  {"read", (PyCFunction)py_candle_shared_reader_read, METH_VARARGS, "Reads next frame"},
+  {"read_many", (PyCFunction)py_candle_shared_reader_read_many, METH_VARARGS | METH_KEYWORDS, "Reads list of available frames"},
+  {"readinto", (PyCFunction)py_candle_shared_reader_readinto, METH_VARARGS | METH_KEYWORDS, "Read available frames into preallocated buffer"},
+  {"write", (PyCFunction)py_candle_shared_reader_write, METH_VARARGS, "Queues frame for transmission by the publisher"},
+  {"close", (PyCFunction)py_candle_shared_reader_close, METH_NOARGS, "Detaches from the publisher"},
+  {NULL}  /* Sentinel */
+};
+
+PyTypeObject py_candle_shared_reader_type = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "candle_driver.SharedReader",
+  .tp_doc = "Reader of frames published by another process with device.start_publisher()",
+  .tp_basicsize = sizeof(py_candle_shared_reader),
+  .tp_itemsize = 0,
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_new = py_candle_shared_reader_new,
+  .tp_init = (initproc)py_candle_shared_reader_init,
+  .tp_dealloc = (destructor)py_candle_shared_reader_dealloc,
+  .tp_members = py_candle_shared_reader_members,
+  .tp_getset = py_candle_shared_reader_getset,
+  .tp_methods = py_candle_shared_reader_methods,
+};
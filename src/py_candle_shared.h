@@ -0,0 +1,25 @@
+#ifndef _PY_CANDLE_SHARED_H_
+#define _PY_CANDLE_SHARED_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include "candle_api/candle.h"
+#include <windows.h>
+#include "shm.h"
+
+// Frames returned by one read_many() call
+#define CANDLE_SHARED_BATCH_MAX 256
+
+typedef struct py_candle_shared_reader {
+  PyObject_HEAD
+
+  // Attachment to publisher shared memory, NULL after close(). The lock
+  // serializes readers of this object while the GIL is released
+  shm_reader_t* _reader;
+  SRWLOCK _lock;
+} py_candle_shared_reader;
+
+extern PyTypeObject py_candle_shared_reader_type;
+
+#endif
@@ -0,0 +1,171 @@
+#include "py_candle_subscription.h"
+#include "py_candle_frame.h"
+
+void py_candle_subscription_dealloc(py_candle_subscription* self)
+{
+  Py_XDECREF(self->_channel);
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+PyObject* py_candle_subscription_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  py_candle_subscription* self = (py_candle_subscription*)type->tp_alloc(type, 0);
+
+  if (!self)
+    return NULL;
+
+  if (!PyArg_ParseTuple(args, "O!", &py_candle_channel_type, &self->_channel))
+  {
+    type->tp_free((PyObject*)self);
+    return NULL;
+  }
+
+  if (!self->_channel->_broadcast)
+  {
+    type->tp_free((PyObject*)self);
+    return PyErr_Format(PyExc_RuntimeError, "Use channel.subscribe() to create subscriptions.");
+  }
+
+  // Keep channel and its ring alive
+  Py_INCREF(self->_channel);
+
+  // Only frames received from now on are seen
+  InitializeSRWLock(&self->_lock);
+  self->_cursor = broadcast_tail(self->_channel->_broadcast);
+  self->_dropped = 0;
+
+  return (PyObject*)self;
+}
+
+int py_candle_subscription_init(py_candle_subscription *self, PyObject *args, PyObject *kwds)
+{
+  return 0;
+}
+
+static size_t py_candle_subscription_read_frames(py_candle_subscription* self, candle_frame_t* frames, size_t max_count, uint32_t timeout_ms)
+{
+  size_t count;
+
+  Py_BEGIN_ALLOW_THREADS
+  AcquireSRWLockExclusive(&self->_lock);
+  count = broadcast_read(self->_channel->_broadcast, &self->_cursor, frames, max_count, timeout_ms, &self->_dropped);
+  ReleaseSRWLockExclusive(&self->_lock);
+  Py_END_ALLOW_THREADS
+
+  return count;
+}
+
+PyObject* py_candle_subscription_read(py_candle_subscription* self, PyObject* args)
+{
+  uint32_t timeout_ms = 0;
+  candle_frame_t frame;
+
+  if (!PyArg_ParseTuple(args, "|O&", py_candle_timeout_converter, &timeout_ms))
+    return NULL;
+
+  if (!py_candle_subscription_read_frames(self, &frame, 1, timeout_ms))
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  return py_candle_frame_from(&frame);
+}
+
+// Returns list of all frames available up to max_frames
+PyObject* py_candle_subscription_read_many(py_candle_subscription* self, PyObject* args, PyObject* kwds)
+{
+  uint32_t max_frames = CANDLE_SUBSCRIPTION_BATCH_MAX;
+  uint32_t timeout_ms = 0;
+  candle_frame_t frames[CANDLE_SUBSCRIPTION_BATCH_MAX];
+
+  static char* kwlist[] = {"max_frames", "timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|IO&", kwlist, &max_frames, py_candle_timeout_converter, &timeout_ms))
+    return NULL;
+
+  if (!max_frames || max_frames > CANDLE_SUBSCRIPTION_BATCH_MAX)
+    return PyErr_Format(PyExc_ValueError, "max_frames must be 1 to %u.", CANDLE_SUBSCRIPTION_BATCH_MAX);
+
+  size_t count = py_candle_subscription_read_frames(self, frames, max_frames, timeout_ms);
+  if (!count)
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  PyObject* res = PyList_New(count);
+  for (size_t i = 0; res && i < count; ++i) {
+    PyObject* frame = py_candle_frame_from(&frames[i]);
+    if (!frame) {
+      Py_CLEAR(res);
+      break;
+    }
+    PyList_SET_ITEM(res, i, frame);
+  }
+
+  return res;
+}
+
+// Reads frames into writable buffer like channel.readinto()
+PyObject* py_candle_subscription_readinto(py_candle_subscription* self, PyObject* args, PyObject* kwds)
+{
+  Py_buffer view;
+  uint32_t timeout_ms = 0;
+
+  static char* kwlist[] = {"buffer", "timeout", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "w*|O&", kwlist, &view, py_candle_timeout_converter, &timeout_ms))
+    return NULL;
+
+  size_t max_frames = view.len / sizeof(candle_frame_t);
+  if (!max_frames) {
+    PyBuffer_Release(&view);
+    return PyErr_Format(PyExc_ValueError, "Buffer is smaller than one frame (%zu bytes).", sizeof(candle_frame_t));
+  }
+
+  size_t count = py_candle_subscription_read_frames(self, view.buf, max_frames, timeout_ms);
+  PyBuffer_Release(&view);
+
+  if (!count)
+    return PyErr_Format(PyExc_TimeoutError, "CAN read timeout.");
+
+  return PyLong_FromSize_t(count);
+}
+
+static PyObject* py_candle_subscription_get_dropped(py_candle_subscription* self, void* closure)
+{
+  return PyLong_FromUnsignedLongLong(self->_dropped);
+}
+
+// Frames waiting to be read, may exceed ring size when reader fell behind
+static PyObject* py_candle_subscription_get_pending(py_candle_subscription* self, void* closure)
+{
+  return PyLong_FromLongLong(broadcast_tail(self->_channel->_broadcast) - self->_cursor);
+}
+
+PyMemberDef py_candle_subscription_members[] = {
+  {NULL}  /* Sentinel */
+};
+
+PyGetSetDef py_candle_subscription_getset[] = {
+  {"dropped", (getter)py_candle_subscription_get_dropped, NULL, "Frames overwritten before this subscriber read them", NULL},
+  {"pending", (getter)py_candle_subscription_get_pending, NULL, "Frames received but not read yet", NULL},
+  {NULL}  /* Sentinel */
+};
+
+PyMethodDef py_candle_subscription_methods[] = {
+  {"read", (PyCFunction)py_candle_subscription_read, METH_VARARGS, "Reads next frame"},
+  {"read_many", (PyCFunction)py_candle_subscription_read_many, METH_VARARGS | METH_KEYWORDS, "Reads list of available frames"},
+  {"readinto", (PyCFunction)py_candle_subscription_readinto, METH_VARARGS | METH_KEYWORDS, "Read available frames into preallocated buffer"},
+  {NULL}  /* Sentinel */
+};
+
+PyTypeObject py_candle_subscription_type = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "candle_driver.Subscription",
+  .tp_doc = "Independent reader of all frames received by a channel",
+  .tp_basicsize = sizeof(py_candle_subscription),
+  .tp_itemsize = 0,
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_new = py_candle_subscription_new,
+  .tp_init = (initproc)py_candle_subscription_init,
+  .tp_dealloc = (destructor)py_candle_subscription_dealloc,
+  .tp_members = py_candle_subscription_members,
+  .tp_getset = py_candle_subscription_getset,
+  .tp_methods = py_candle_subscription_methods,
+};
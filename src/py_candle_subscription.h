@@ -0,0 +1,29 @@
+#ifndef _PY_CANDLE_SUBSCRIPTION_H_
+#define _PY_CANDLE_SUBSCRIPTION_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include "candle_api/candle.h"
+#include "py_candle_channel.h"
+#include "broadcast.h"
+
+// Frames returned by one read_many() call
+#define CANDLE_SUBSCRIPTION_BATCH_MAX 256
+
+typedef struct py_candle_subscription {
+  PyObject_HEAD
+
+  // Channel owning the broadcast ring
+  py_candle_channel* _channel;
+
+  // Read position in the ring and frames skipped because of overrun. The
+  // lock serializes readers of this subscription while the GIL is released
+  SRWLOCK _lock;
+  int64_t _cursor;
+  uint64_t _dropped;
+} py_candle_subscription;
+
+extern PyTypeObject py_candle_subscription_type;
+
+#endif
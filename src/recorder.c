@@ -0,0 +1,293 @@
+#include "recorder.h"
+#include "timing.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// stdio buffer of the capture file
+#define RECORDER_FILE_BUF_SIZE 65536
+
+struct recorder_t {
+  recorder_config_t config;
+  char* path;
+
+  candle_frame_t* buf;
+  size_t mask;
+  uint64_t write_seq;
+
+  // Only the RX thread moves the state away from RECORDER_ARMED and
+  // RECORDER_TRIGGERED, only the dump thread moves it back
+  volatile LONG state;
+  volatile bool trigger_req;
+  // First frame after the trigger
+  uint64_t trigger_seq;
+  uint64_t trigger_time_us;
+
+  HANDLE dump_event;
+  HANDLE thread;
+  volatile bool stop_req;
+
+  recorder_stats_t stats;
+};
+
+static bool recorder_match(recorder_t* recorder, const candle_frame_t* frame)
+{
+  candle_frametype_t type = candle_frame_type((candle_frame_t*)frame);
+
+  if (type == CANDLE_FRAMETYPE_ERROR)
+    return recorder->config.trigger_on_error;
+
+  if (type != CANDLE_FRAMETYPE_RECEIVE)
+    return false;
+
+  uint8_t size = candle_frame_size((candle_frame_t*)frame);
+
+  for (uint8_t i = 0; i < recorder->config.trigger_count; ++i) {
+    const recorder_trigger_t* trigger = &recorder->config.triggers[i];
+
+    if ((frame->can_id & trigger->mask) != (trigger->can_id & trigger->mask))
+      continue;
+    if (size < trigger->data_len)
+      continue;
+
+    uint8_t j = 0;
+    while (j < trigger->data_len && !((frame->data[j] ^ trigger->data[j]) & trigger->data_mask[j]))
+      ++j;
+
+    if (j == trigger->data_len)
+      return true;
+  }
+
+  return false;
+}
+
+static void recorder_start_post(recorder_t* recorder, uint64_t seq, uint64_t time_us)
+{
+  recorder->trigger_req = false;
+  recorder->trigger_seq = seq;
+  recorder->trigger_time_us = time_us;
+  recorder->stats.triggers++;
+  InterlockedExchange(&recorder->state, RECORDER_TRIGGERED);
+}
+
+static void recorder_check_post(recorder_t* recorder, uint64_t now)
+{
+  bool done = now - recorder->trigger_time_us >= recorder->config.post_us;
+
+  if (recorder->config.post_frames && recorder->write_seq - recorder->trigger_seq >= recorder->config.post_frames)
+    done = true;
+
+  if (done) {
+    // Interlocked exchange publishes the ring to the dump thread
+    InterlockedExchange(&recorder->state, RECORDER_DUMPING);
+    SetEvent(recorder->dump_event);
+  }
+}
+
+void recorder_add(recorder_t* recorder, const candle_frame_t* frame)
+{
+  if (recorder->state == RECORDER_DUMPING) {
+    recorder->stats.missed++;
+    return;
+  }
+
+  memcpy(&recorder->buf[recorder->write_seq & recorder->mask], frame, sizeof(candle_frame_t));
+  recorder->write_seq++;
+  recorder->stats.frames++;
+
+  if (recorder->state == RECORDER_ARMED && (recorder->trigger_req || recorder_match(recorder, frame)))
+    recorder_start_post(recorder, recorder->write_seq, frame->host_timestamp_us);
+
+  if (recorder->state == RECORDER_TRIGGERED)
+    recorder_check_post(recorder, frame->host_timestamp_us);
+}
+
+void recorder_poll(recorder_t* recorder)
+{
+  uint64_t now = timing_now_us();
+
+  if (recorder->state == RECORDER_ARMED && recorder->trigger_req)
+    recorder_start_post(recorder, recorder->write_seq, now);
+
+  if (recorder->state == RECORDER_TRIGGERED)
+    recorder_check_post(recorder, now);
+}
+
+bool recorder_trigger(recorder_t* recorder)
+{
+  if (recorder->state != RECORDER_ARMED)
+    return false;
+
+  recorder->trigger_req = true;
+  return true;
+}
+
+recorder_state_t recorder_state(recorder_t* recorder)
+{
+  return (recorder_state_t)recorder->state;
+}
+
+const recorder_stats_t* recorder_stats(recorder_t* recorder)
+{
+  return &recorder->stats;
+}
+
+// Writes frame as candump log line, error frames keep CAN_ERR_FLAG in the id
+static void recorder_write_frame(FILE* file, const candle_frame_t* frame, int64_t wall_offset_us)
+{
+  uint64_t time_us = frame->host_timestamp_us + wall_offset_us;
+  uint32_t id = frame->can_id & 0x1FFFFFFF;
+  bool extended = (frame->can_id & CANDLE_ID_EXTENDED) != 0;
+  candle_frametype_t type = candle_frame_type((candle_frame_t*)frame);
+  uint8_t size = candle_frame_size((candle_frame_t*)frame);
+
+  fprintf(file, "(%llu.%06llu) can%u ", (unsigned long long)(time_us / 1000000), (unsigned long long)(time_us % 1000000), frame->channel);
+
+  if (type == CANDLE_FRAMETYPE_ERROR)
+    fprintf(file, "%08X#", id | CANDLE_ID_ERR);
+  else if (extended)
+    fprintf(file, "%08X#", id);
+  else
+    fprintf(file, "%03X#", id);
+
+  if (frame->flags & CANDLE_FLAG_FD) {
+    fprintf(file, "#%X", ((frame->flags & CANDLE_FLAG_BRS) ? 1 : 0) | ((frame->flags & CANDLE_FLAG_ESI) ? 2 : 0));
+  } else if (frame->can_id & CANDLE_ID_RTR) {
+    fputc('R', file);
+    size = 0;
+  }
+
+  for (uint8_t i = 0; i < size; ++i)
+    fprintf(file, "%02X", frame->data[i]);
+
+  fputc('\n', file);
+}
+
+static void recorder_dump(recorder_t* recorder)
+{
+  char name[MAX_PATH];
+  const char* path = recorder->path;
+  const char* ext = strrchr(path, '.');
+
+  // Dot of a directory name is not an extension
+  if (!ext || strpbrk(ext, "\\/"))
+    ext = path + strlen(path);
+
+  snprintf(name, sizeof(name), "%.*s_%04llu%s", (int)(ext - path), path, (unsigned long long)recorder->stats.dumps + 1, ext);
+
+  FILE* file = fopen(name, "w");
+  if (!file) {
+    recorder->stats.dump_errors++;
+    return;
+  }
+  setvbuf(file, NULL, _IOFBF, RECORDER_FILE_BUF_SIZE);
+
+  // Host timestamps are monotonic, candump logs use unix time
+  FILETIME ft;
+  GetSystemTimePreciseAsFileTime(&ft);
+  uint64_t wall_us = ((((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime) - 116444736000000000ull) / 10;
+  int64_t wall_offset_us = (int64_t)(wall_us - timing_now_us());
+
+  uint64_t end = recorder->write_seq;
+  uint64_t start = end > recorder->mask + 1 ? end - (recorder->mask + 1) : 0;
+  uint64_t pre_start_us = recorder->trigger_time_us - recorder->config.pre_us;
+  uint64_t count = 0;
+
+  for (uint64_t seq = start; seq < end; ++seq) {
+    const candle_frame_t* frame = &recorder->buf[seq & recorder->mask];
+
+    if (recorder->config.pre_us && seq < recorder->trigger_seq && frame->host_timestamp_us < pre_start_us)
+      continue;
+
+    recorder_write_frame(file, frame, wall_offset_us);
+    count++;
+  }
+
+  if (ferror(file) | fclose(file)) {
+    recorder->stats.dump_errors++;
+    return;
+  }
+
+  recorder->stats.dumps++;
+  recorder->stats.dumped_frames += count;
+}
+
+static DWORD WINAPI recorder_thread(LPVOID lpParam)
+{
+  recorder_t* recorder = (recorder_t*)lpParam;
+
+  while (!recorder->stop_req) {
+    if (WaitForSingleObject(recorder->dump_event, RECORDER_POLL_INTERVAL) != WAIT_OBJECT_0)
+      continue;
+
+    recorder_dump(recorder);
+
+    // Recording restarts after the dumped frames, triggers requested
+    // meanwhile are dropped
+    recorder->write_seq = 0;
+    recorder->trigger_req = false;
+    InterlockedExchange(&recorder->state, RECORDER_ARMED);
+  }
+
+  // Frozen ring is still written when stopping
+  if (recorder->state == RECORDER_DUMPING)
+    recorder_dump(recorder);
+
+  return 0;
+}
+
+recorder_t* recorder_create(const recorder_config_t* config)
+{
+  if (config->capacity > RECORDER_MAX_SIZE)
+    return NULL;
+
+  recorder_t* recorder = calloc(1, sizeof(recorder_t));
+  if (!recorder)
+    return NULL;
+
+  size_t size = 16;
+  while (size < config->capacity)
+    size <<= 1;
+
+  recorder->config = *config;
+  recorder->path = _strdup(config->path);
+  recorder->config.path = recorder->path;
+  recorder->buf = malloc(size*sizeof(candle_frame_t));
+  recorder->mask = size - 1;
+  recorder->state = RECORDER_ARMED;
+  recorder->dump_event = CreateEvent(NULL, false, false, NULL);
+
+  DWORD id;
+  if (recorder->path && recorder->buf && recorder->dump_event)
+    recorder->thread = CreateThread(NULL, 0, recorder_thread, (PVOID)recorder, 0, &id);
+
+  if (!recorder->thread) {
+    recorder_delete(recorder);
+    return NULL;
+  }
+
+  return recorder;
+}
+
+void recorder_delete(recorder_t* recorder)
+{
+  if (!recorder)
+    return;
+
+  if (recorder->thread) {
+    // RX thread no longer records, freeze the post-trigger window here so
+    // the dump thread writes it before exiting
+    InterlockedCompareExchange(&recorder->state, RECORDER_DUMPING, RECORDER_TRIGGERED);
+    recorder->stop_req = true;
+    WaitForSingleObject(recorder->thread, INFINITE);
+    CloseHandle(recorder->thread);
+  }
+
+  if (recorder->dump_event)
+    CloseHandle(recorder->dump_event);
+
+  free(recorder->buf);
+  free(recorder->path);
+  free(recorder);
+}
@@ -0,0 +1,85 @@
+#ifndef _RECORDER_H_
+#define _RECORDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "candle_api/candle.h"
+
+#define RECORDER_MAX_TRIGGERS 16
+#define RECORDER_DEFAULT_SIZE 65536
+// Largest ring in frames, about 300 MB
+#define RECORDER_MAX_SIZE (1 << 22)
+// Interval at which the dump thread checks for stop
+#define RECORDER_POLL_INTERVAL 100 // in ms
+
+typedef enum {
+  // Recording and watching triggers
+  RECORDER_ARMED,
+  // Triggered, recording the post-trigger window
+  RECORDER_TRIGGERED,
+  // Frozen while the dump thread writes the capture file
+  RECORDER_DUMPING,
+} recorder_state_t;
+
+// Received frame matches if (can_id & mask) == (trigger can_id & mask) and
+// the first data_len bytes match under data_mask
+typedef struct recorder_trigger_t {
+  uint32_t can_id;
+  uint32_t mask;
+  uint8_t data[64];
+  uint8_t data_mask[64];
+  uint8_t data_len;
+} recorder_trigger_t;
+
+typedef struct recorder_config_t {
+  // Capture file name, dump number is inserted before the extension
+  const char* path;
+  // Ring size in frames, rounded up to a power of two
+  size_t capacity;
+  // Frames older than this before the trigger are not dumped, 0 dumps all
+  uint64_t pre_us;
+  // Post-trigger window ends after this time or frame count, whichever
+  // comes first (0 count is unlimited)
+  uint64_t post_us;
+  uint64_t post_frames;
+
+  recorder_trigger_t triggers[RECORDER_MAX_TRIGGERS];
+  uint8_t trigger_count;
+  bool trigger_on_error;
+} recorder_config_t;
+
+typedef struct recorder_stats_t {
+  uint64_t frames;
+  // Frames not recorded while a dump was being written
+  uint64_t missed;
+  uint64_t triggers;
+  uint64_t dumps;
+  uint64_t dump_errors;
+  uint64_t dumped_frames;
+} recorder_stats_t;
+
+// Flight recorder. RX thread copies every frame into a fixed ring, a trigger
+// freezes the ring after the post-trigger window and a dump thread writes
+// it as candump log while the RX thread skips recording.
+typedef struct recorder_t recorder_t;
+
+// Returns NULL if capacity exceeds RECORDER_MAX_SIZE
+recorder_t* recorder_create(const recorder_config_t* config);
+// Waits for a dump in progress. A capture still in its post-trigger window
+// is cut short and dumped as well
+void recorder_delete(recorder_t* recorder);
+
+// Records frame, called by the single RX thread
+void recorder_add(recorder_t* recorder, const candle_frame_t* frame);
+// Closes the post-trigger window on a quiet bus, called by the RX thread
+// when no frame arrived
+void recorder_poll(recorder_t* recorder);
+
+// Requests trigger at the next frame or poll, false if not armed
+bool recorder_trigger(recorder_t* recorder);
+
+recorder_state_t recorder_state(recorder_t* recorder);
+const recorder_stats_t* recorder_stats(recorder_t* recorder);
+
+#endif
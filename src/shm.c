@@ -0,0 +1,543 @@
+#include "shm.h"
+#include "broadcast.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SHM_NAME_MAX 256
+
+typedef struct shm_slot_t {
+  // Owner process id, 0 when free
+  volatile LONG pid;
+  // Set while the reader sleeps on its event
+  volatile LONG waiting;
+  volatile int64_t cursor;
+  volatile int64_t dropped;
+} shm_slot_t;
+
+// Start of the mapping, RX items and TX items follow
+typedef struct shm_header_t {
+  // Written last by the publisher, readers check it first
+  volatile uint32_t magic;
+  uint32_t version;
+  uint32_t element_size;
+  uint32_t element_count;
+
+  // 0 once the publisher is gone
+  volatile LONG publisher_pid;
+  // Number of sleeping readers, publisher skips the slot scan when 0
+  volatile LONG waiters;
+  volatile int64_t write_seq;
+  // Bumped when a publisher takes over the ring, items before start_seq
+  // belong to the previous one
+  volatile LONG generation;
+  volatile int64_t start_seq;
+  shm_slot_t slots[SHM_MAX_READERS];
+
+  // TX requests, many producers serialized by the named tx lock mutex, one
+  // consumer
+  volatile int64_t tx_write_seq;
+  volatile int64_t tx_read_seq;
+  volatile int64_t tx_rejected;
+} shm_header_t;
+
+struct shm_publisher_t {
+  HANDLE mapping;
+  shm_header_t* header;
+  void* rx_buf;
+  void* tx_buf;
+  size_t mask;
+
+  HANDLE slot_events[SHM_MAX_READERS];
+  HANDLE tx_event;
+  HANDLE tx_lock;
+
+  // TX thread, also reclaims slots of dead readers
+  HANDLE thread;
+  volatile bool stop;
+  shm_send_t send;
+  void* ctx;
+};
+
+struct shm_reader_t {
+  HANDLE mapping;
+  shm_header_t* header;
+  void* rx_buf;
+  void* tx_buf;
+  size_t mask;
+
+  shm_slot_t* slot;
+  // Publisher generation the cursor belongs to
+  LONG generation;
+  HANDLE event;
+  HANDLE tx_event;
+  HANDLE tx_lock;
+};
+
+static void shm_object_name(char* buf, const char* name, const char* suffix, int index)
+{
+  if (index < 0)
+    snprintf(buf, SHM_NAME_MAX, "%s.%s", name, suffix);
+  else
+    snprintf(buf, SHM_NAME_MAX, "%s.%s%d", name, suffix, index);
+}
+
+static void shm_layout(shm_header_t* header, void** rx_buf, void** tx_buf)
+{
+  *rx_buf = (uint8_t*)header + sizeof(shm_header_t);
+  *tx_buf = (uint8_t*)*rx_buf + (size_t)header->element_size*header->element_count;
+}
+
+// Returns false only if the process is known to have exited
+static bool shm_process_alive(DWORD pid)
+{
+  HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, false, pid);
+
+  // Access denied still means the process exists
+  if (!process)
+    return GetLastError() != ERROR_INVALID_PARAMETER;
+
+  DWORD exit_code;
+  bool alive = !GetExitCodeProcess(process, &exit_code) || exit_code == STILL_ACTIVE;
+  CloseHandle(process);
+
+  return alive;
+}
+
+// Frees slots of readers that exited without shm_reader_close
+static void shm_publisher_reap(shm_publisher_t* publisher)
+{
+  shm_header_t* header = publisher->header;
+
+  for (int i = 0; i < SHM_MAX_READERS; ++i) {
+    shm_slot_t* slot = &header->slots[i];
+    LONG pid = slot->pid;
+
+    if (!pid || shm_process_alive((DWORD)pid))
+      continue;
+
+    // Reader died asleep, its waiter count would keep the slot scan on
+    if (InterlockedExchange(&slot->waiting, 0))
+      InterlockedDecrement(&header->waiters);
+
+    InterlockedCompareExchange(&slot->pid, 0, pid);
+  }
+}
+
+DWORD WINAPI shm_publisher_thread(LPVOID param)
+{
+  shm_publisher_t* publisher = (shm_publisher_t*)param;
+  shm_header_t* header = publisher->header;
+  size_t element_size = header->element_size;
+  uint8_t item[512];
+  ULONGLONG next_reap = GetTickCount64() + SHM_REAP_INTERVAL_MS;
+
+  while (!publisher->stop) {
+    WaitForSingleObject(publisher->tx_event, SHM_REAP_INTERVAL_MS);
+
+    if (GetTickCount64() >= next_reap) {
+      shm_publisher_reap(publisher);
+      next_reap = GetTickCount64() + SHM_REAP_INTERVAL_MS;
+    }
+
+    while (!publisher->stop && header->tx_read_seq != header->tx_write_seq) {
+      // Single consumer, producers never touch the slot at tx_read_seq
+      MemoryBarrier();
+      memcpy(item, (uint8_t*)publisher->tx_buf + ((size_t)header->tx_read_seq % SHM_TX_SIZE)*element_size, element_size);
+      MemoryBarrier();
+      header->tx_read_seq++;
+
+      publisher->send(publisher->ctx, item);
+    }
+  }
+
+  return 0;
+}
+
+shm_publisher_t* shm_publisher_create(const char* name, size_t element_size, size_t element_count, shm_send_t send, void* ctx)
+{
+  char object_name[SHM_NAME_MAX];
+  size_t count = 16;
+
+  while (count < element_count)
+    count <<= 1;
+
+  // TX thread copies items to a local buffer
+  if (element_size > 512)
+    return NULL;
+
+  size_t size = sizeof(shm_header_t) + element_size*(count + SHM_TX_SIZE);
+
+  shm_publisher_t* publisher = calloc(1, sizeof(shm_publisher_t));
+  if (!publisher)
+    return NULL;
+
+  publisher->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, name);
+  if (!publisher->mapping) {
+    shm_publisher_delete(publisher);
+    return NULL;
+  }
+
+  bool existing = GetLastError() == ERROR_ALREADY_EXISTS;
+
+  shm_header_t* header = MapViewOfFile(publisher->mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (!header) {
+    shm_publisher_delete(publisher);
+    return NULL;
+  }
+
+  LONG pid = (LONG)GetCurrentProcessId();
+
+  if (existing) {
+    // Readers keep the ring of a stopped publisher alive. It is taken over
+    // if the layout matches and its publisher is gone, the exchange settles
+    // two publishers starting at once
+    LONG old_pid = header->publisher_pid;
+    int64_t tx_stale = header->tx_write_seq;
+
+    if (header->magic != SHM_MAGIC || header->version != SHM_VERSION ||
+        header->element_size != element_size || header->element_count != count ||
+        (old_pid && shm_process_alive((DWORD)old_pid)) ||
+        InterlockedCompareExchange(&header->publisher_pid, pid, old_pid) != old_pid) {
+      // Not ours, delete must not mark it stopped
+      UnmapViewOfFile(header);
+      shm_publisher_delete(publisher);
+      return NULL;
+    }
+
+    // TX requests queued for the previous publisher are not sent, the
+    // consumer side is ours alone until the thread starts
+    header->tx_read_seq = tx_stale;
+
+    // Readers skip unread items of the previous session, device timestamps
+    // restart with the device
+    header->start_seq = header->write_seq;
+    MemoryBarrier();
+    InterlockedIncrement(&header->generation);
+  } else {
+    // New mapping is zero filled
+    header->version = SHM_VERSION;
+    header->element_size = (uint32_t)element_size;
+    header->element_count = (uint32_t)count;
+    header->publisher_pid = pid;
+  }
+
+  publisher->header = header;
+  shm_layout(header, &publisher->rx_buf, &publisher->tx_buf);
+  publisher->mask = count - 1;
+
+  for (int i = 0; i < SHM_MAX_READERS; ++i) {
+    shm_object_name(object_name, name, "reader", i);
+    publisher->slot_events[i] = CreateEventA(NULL, false, false, object_name);
+  }
+
+  shm_object_name(object_name, name, "tx", -1);
+  publisher->tx_event = CreateEventA(NULL, false, false, object_name);
+  shm_object_name(object_name, name, "txlock", -1);
+  publisher->tx_lock = CreateMutexA(NULL, false, object_name);
+
+  publisher->send = send;
+  publisher->ctx = ctx;
+  publisher->stop = false;
+
+  DWORD id;
+  publisher->thread = CreateThread(NULL, 0, shm_publisher_thread, (PVOID)publisher, 0, &id);
+
+  if (!publisher->tx_event || !publisher->tx_lock || !publisher->thread) {
+    shm_publisher_delete(publisher);
+    return NULL;
+  }
+
+  // Readers attach only after everything is set up
+  MemoryBarrier();
+  header->magic = SHM_MAGIC;
+
+  return publisher;
+}
+
+void shm_publisher_delete(shm_publisher_t* publisher)
+{
+  if (!publisher)
+    return;
+
+  if (publisher->thread) {
+    publisher->stop = true;
+    SetEvent(publisher->tx_event);
+    WaitForSingleObject(publisher->thread, INFINITE);
+    CloseHandle(publisher->thread);
+  }
+
+  if (publisher->header) {
+    publisher->header->publisher_pid = 0;
+
+    // Wake sleeping readers so they notice
+    for (int i = 0; i < SHM_MAX_READERS; ++i)
+      if (publisher->slot_events[i] && publisher->header->slots[i].waiting)
+        SetEvent(publisher->slot_events[i]);
+
+    UnmapViewOfFile(publisher->header);
+  }
+
+  for (int i = 0; i < SHM_MAX_READERS; ++i)
+    if (publisher->slot_events[i])
+      CloseHandle(publisher->slot_events[i]);
+
+  if (publisher->tx_event)
+    CloseHandle(publisher->tx_event);
+  if (publisher->tx_lock)
+    CloseHandle(publisher->tx_lock);
+
+  // Mapping lives on while readers keep it open
+  if (publisher->mapping)
+    CloseHandle(publisher->mapping);
+
+  free(publisher);
+}
+
+void shm_publish(shm_publisher_t* publisher, const void* item)
+{
+  shm_header_t* header = publisher->header;
+
+  broadcast_store(publisher->rx_buf, header->element_size, publisher->mask, &header->write_seq, item);
+
+  if (header->waiters) {
+    for (int i = 0; i < SHM_MAX_READERS; ++i)
+      if (header->slots[i].waiting)
+        SetEvent(publisher->slot_events[i]);
+  }
+}
+
+size_t shm_publisher_readers(shm_publisher_t* publisher, shm_reader_info_t* info, size_t max_count)
+{
+  shm_header_t* header = publisher->header;
+  size_t count = 0;
+
+  for (int i = 0; i < SHM_MAX_READERS && count < max_count; ++i) {
+    shm_slot_t* slot = &header->slots[i];
+    if (!slot->pid)
+      continue;
+
+    info[count].pid = (uint32_t)slot->pid;
+    info[count].pending = header->write_seq - slot->cursor;
+    info[count].dropped = (uint64_t)slot->dropped;
+    count++;
+  }
+
+  return count;
+}
+
+uint64_t shm_publisher_tx_rejected(shm_publisher_t* publisher)
+{
+  return (uint64_t)publisher->header->tx_rejected;
+}
+
+shm_reader_t* shm_reader_open(const char* name, size_t element_size)
+{
+  char object_name[SHM_NAME_MAX];
+
+  shm_reader_t* reader = calloc(1, sizeof(shm_reader_t));
+  if (!reader)
+    return NULL;
+
+  reader->mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, false, name);
+  if (!reader->mapping) {
+    shm_reader_close(reader);
+    return NULL;
+  }
+
+  shm_header_t* header = MapViewOfFile(reader->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+  reader->header = header;
+
+  if (!header || header->magic != SHM_MAGIC || header->version != SHM_VERSION ||
+      header->element_size != element_size || !header->publisher_pid) {
+    shm_reader_close(reader);
+    return NULL;
+  }
+
+  MemoryBarrier();
+  shm_layout(header, &reader->rx_buf, &reader->tx_buf);
+  reader->mask = header->element_count - 1;
+
+  LONG pid = (LONG)GetCurrentProcessId();
+  int index;
+
+  for (index = 0; index < SHM_MAX_READERS; ++index) {
+    if (!InterlockedCompareExchange(&header->slots[index].pid, pid, 0))
+      break;
+  }
+
+  if (index == SHM_MAX_READERS) {
+    shm_reader_close(reader);
+    return NULL;
+  }
+
+  reader->slot = &header->slots[index];
+  reader->generation = header->generation;
+  MemoryBarrier();
+  reader->slot->waiting = 0;
+  reader->slot->dropped = 0;
+  reader->slot->cursor = header->write_seq;
+
+  shm_object_name(object_name, name, "reader", index);
+  reader->event = OpenEventA(SYNCHRONIZE | EVENT_MODIFY_STATE, false, object_name);
+  shm_object_name(object_name, name, "tx", -1);
+  reader->tx_event = OpenEventA(EVENT_MODIFY_STATE, false, object_name);
+  shm_object_name(object_name, name, "txlock", -1);
+  reader->tx_lock = OpenMutexA(SYNCHRONIZE | MUTEX_MODIFY_STATE, false, object_name);
+
+  if (!reader->event || !reader->tx_event || !reader->tx_lock) {
+    shm_reader_close(reader);
+    return NULL;
+  }
+
+  return reader;
+}
+
+void shm_reader_close(shm_reader_t* reader)
+{
+  if (!reader)
+    return;
+
+  if (reader->slot)
+    InterlockedExchange(&reader->slot->pid, 0);
+
+  if (reader->event)
+    CloseHandle(reader->event);
+  if (reader->tx_event)
+    CloseHandle(reader->tx_event);
+  if (reader->tx_lock)
+    CloseHandle(reader->tx_lock);
+  if (reader->header)
+    UnmapViewOfFile(reader->header);
+  if (reader->mapping)
+    CloseHandle(reader->mapping);
+
+  free(reader);
+}
+
+static bool shm_reader_wait(shm_reader_t* reader, int64_t cursor, uint32_t timeout)
+{
+  shm_header_t* header = reader->header;
+
+  if (header->write_seq != cursor)
+    return true;
+
+  if (!timeout)
+    return false;
+
+  ULONGLONG deadline = GetTickCount64() + timeout;
+
+  // Interlocked operations order the flag before the check, publisher does
+  // the same in reverse so one of them sees the other
+  InterlockedExchange(&reader->slot->waiting, 1);
+  InterlockedIncrement(&header->waiters);
+
+  while (header->write_seq == cursor && header->publisher_pid) {
+    uint32_t wait_ms = INFINITE;
+
+    if (timeout != INFINITE) {
+      ULONGLONG now = GetTickCount64();
+      if (now >= deadline)
+        break;
+      wait_ms = (uint32_t)(deadline - now);
+    }
+
+    WaitForSingleObject(reader->event, wait_ms);
+  }
+
+  InterlockedDecrement(&header->waiters);
+  InterlockedExchange(&reader->slot->waiting, 0);
+
+  return header->write_seq != cursor;
+}
+
+// Moves the cursor past items of a previous publisher after a takeover
+static void shm_reader_resync(shm_reader_t* reader)
+{
+  shm_header_t* header = reader->header;
+  LONG generation = header->generation;
+
+  if (generation == reader->generation)
+    return;
+
+  // Publisher writes start_seq before bumping the generation
+  MemoryBarrier();
+  int64_t start_seq = header->start_seq;
+
+  if (reader->slot->cursor < start_seq) {
+    reader->slot->dropped += start_seq - reader->slot->cursor;
+    reader->slot->cursor = start_seq;
+  }
+
+  reader->generation = generation;
+}
+
+size_t shm_reader_read(shm_reader_t* reader, void* items, size_t max_count, uint32_t timeout)
+{
+  uint64_t dropped = 0;
+
+  shm_reader_resync(reader);
+
+  if (!max_count || !shm_reader_wait(reader, reader->slot->cursor, timeout))
+    return 0;
+
+  // Publisher may have been replaced while the reader slept
+  shm_reader_resync(reader);
+  int64_t cursor = reader->slot->cursor;
+
+  size_t count = broadcast_copy(reader->rx_buf, reader->header->element_size, reader->mask,
+    &reader->header->write_seq, &cursor, items, max_count, &dropped);
+
+  // Publisher reads these for its reader statistics
+  reader->slot->cursor = cursor;
+  reader->slot->dropped += dropped;
+
+  return count;
+}
+
+bool shm_reader_send(shm_reader_t* reader, const void* item)
+{
+  shm_header_t* header = reader->header;
+
+  if (!header->publisher_pid)
+    return false;
+
+  // Owner that died holding the lock never published its item, the write
+  // sequence only moves after the copy, so an abandoned lock is just taken
+  DWORD wait = WaitForSingleObject(reader->tx_lock, INFINITE);
+  if (wait != WAIT_OBJECT_0 && wait != WAIT_ABANDONED)
+    return false;
+
+  bool res = header->tx_write_seq - header->tx_read_seq < SHM_TX_SIZE;
+
+  if (res) {
+    memcpy((uint8_t*)reader->tx_buf + ((size_t)header->tx_write_seq % SHM_TX_SIZE)*header->element_size, item, header->element_size);
+    MemoryBarrier();
+    header->tx_write_seq++;
+  } else {
+    header->tx_rejected++;
+  }
+
+  ReleaseMutex(reader->tx_lock);
+
+  if (res)
+    SetEvent(reader->tx_event);
+
+  return res;
+}
+
+uint64_t shm_reader_dropped(shm_reader_t* reader)
+{
+  return (uint64_t)reader->slot->dropped;
+}
+
+int64_t shm_reader_pending(shm_reader_t* reader)
+{
+  return reader->header->write_seq - reader->slot->cursor;
+}
+
+bool shm_reader_connected(shm_reader_t* reader)
+{
+  return reader->header->publisher_pid != 0;
+}
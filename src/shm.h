@@ -0,0 +1,63 @@
+#ifndef _SHM_H_
+#define _SHM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SHM_MAGIC 0x4D48534C
+#define SHM_VERSION 3
+#define SHM_MAX_READERS 16
+// Interval of the publisher check for slots of readers that died attached
+#define SHM_REAP_INTERVAL_MS 1000
+// Pending TX requests of all readers
+#define SHM_TX_SIZE 256
+
+// Sends TX request of a reader, called on the publisher TX thread
+typedef bool (*shm_send_t)(void* ctx, const void* item);
+
+// Named shared memory ring written by one publisher process and read by up
+// to SHM_MAX_READERS processes, each with its own cursor in the shared
+// header. Readers wait on per-slot named events that the publisher only
+// signals while they sleep. Readers can queue items into a TX ring that a
+// publisher thread passes to send. That thread also frees slots of reader
+// processes that exited without closing. A publisher started while readers
+// still hold the ring of a stopped one takes it over, readers skip what is
+// left of the previous session
+typedef struct shm_publisher_t shm_publisher_t;
+typedef struct shm_reader_t shm_reader_t;
+
+typedef struct shm_reader_info_t {
+  uint32_t pid;
+  int64_t pending;
+  uint64_t dropped;
+} shm_reader_info_t;
+
+// Returns NULL if a running publisher uses the name or a leftover ring has
+// a different layout. Element count is rounded up to a power of two
+shm_publisher_t* shm_publisher_create(const char* name, size_t element_size, size_t element_count, shm_send_t send, void* ctx);
+void shm_publisher_delete(shm_publisher_t* publisher);
+
+// Called by the single writer thread
+void shm_publish(shm_publisher_t* publisher, const void* item);
+
+// Fills info of attached readers, returns their count
+size_t shm_publisher_readers(shm_publisher_t* publisher, shm_reader_info_t* info, size_t max_count);
+// TX requests rejected because the TX ring was full
+uint64_t shm_publisher_tx_rejected(shm_publisher_t* publisher);
+
+// Returns NULL if there is no publisher, items have a different size or all
+// reader slots are taken
+shm_reader_t* shm_reader_open(const char* name, size_t element_size);
+void shm_reader_close(shm_reader_t* reader);
+
+// Like broadcast_read, starting at the first item published after open
+size_t shm_reader_read(shm_reader_t* reader, void* items, size_t max_count, uint32_t timeout);
+// Queues item for the publisher, false if TX ring is full or publisher is gone
+bool shm_reader_send(shm_reader_t* reader, const void* item);
+
+uint64_t shm_reader_dropped(shm_reader_t* reader);
+int64_t shm_reader_pending(shm_reader_t* reader);
+bool shm_reader_connected(shm_reader_t* reader);
+
+#endif
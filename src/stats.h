@@ -0,0 +1,57 @@
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <windows.h>
+
+// All counters are int64 so snapshots can be handled as arrays. RX thread
+// counters have a single writer, counters updated from python threads use
+// interlocked operations. Reset never writes counters: a baseline snapshot
+// is stored instead and subtracted on read.
+
+typedef struct candle_channel_stats_t {
+  volatile int64_t rx_frames;
+  volatile int64_t rx_bytes;
+  volatile int64_t tx_frames;
+  volatile int64_t tx_bytes;
+  volatile int64_t tx_errors;
+  volatile int64_t echo_frames;
+  volatile int64_t priority_frames;
+} candle_channel_stats_t;
+
+typedef struct candle_device_stats_t {
+  volatile int64_t rx_frames;
+  volatile int64_t rx_wakeups;
+  volatile int64_t usb_read_errors;
+  volatile int64_t short_transfers;
+  volatile int64_t reorder_violations;
+} candle_device_stats_t;
+
+#define STATS_COUNTER_COUNT(stats) (sizeof(stats)/sizeof(int64_t))
+
+// Copies counters and subtracts baseline
+static inline void stats_snapshot(const volatile int64_t* stats, const volatile int64_t* base, int64_t* out, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+    out[i] = stats[i] - base[i];
+}
+
+// Stores current counters as baseline
+static inline void stats_reset(const volatile int64_t* stats, volatile int64_t* base, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+    base[i] = stats[i];
+}
+
+static inline void stats_count_tx(candle_channel_stats_t* stats, uint8_t size, bool ok)
+{
+  if (ok) {
+    InterlockedIncrement64(&stats->tx_frames);
+    InterlockedExchangeAdd64(&stats->tx_bytes, size);
+  } else {
+    InterlockedIncrement64(&stats->tx_errors);
+  }
+}
+
+#endif
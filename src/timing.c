@@ -0,0 +1,56 @@
+#include "timing.h"
+#include <windows.h>
+
+// Missing from older SDKs
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+uint64_t timing_now_us(void)
+{
+  static LARGE_INTEGER freq = {0};
+  LARGE_INTEGER counter;
+
+  // Frequency is fixed at system boot so it is enough to query it once
+  if (!freq.QuadPart)
+    QueryPerformanceFrequency(&freq);
+
+  QueryPerformanceCounter(&counter);
+
+  // Split to avoid overflow of counter*1000000
+  return (uint64_t)(counter.QuadPart / freq.QuadPart) * 1000000 +
+    (uint64_t)(counter.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+}
+
+void timing_sleep_until_us(uint64_t deadline_us)
+{
+  uint64_t now = timing_now_us();
+
+  if (now + TIMING_SPIN_MARGIN_US < deadline_us) {
+    HANDLE timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+    if (timer) {
+      // Relative due time in 100ns units
+      LARGE_INTEGER due;
+      due.QuadPart = -(LONGLONG)(deadline_us - now - TIMING_SPIN_MARGIN_US) * 10;
+
+      if (SetWaitableTimer(timer, &due, 0, NULL, NULL, FALSE))
+        WaitForSingleObject(timer, INFINITE);
+
+      CloseHandle(timer);
+      now = timing_now_us();
+    }
+
+    // Coarse sleep if there is no high resolution timer
+    while (now + TIMING_SPIN_MARGIN_COARSE_US < deadline_us) {
+      Sleep((DWORD)((deadline_us - now - TIMING_SPIN_MARGIN_COARSE_US) / 1000));
+      now = timing_now_us();
+    }
+  }
+
+  // Spin for the remaining time
+  while (now < deadline_us) {
+    YieldProcessor();
+    now = timing_now_us();
+  }
+}
@@ -0,0 +1,19 @@
+#ifndef _TIMING_H_
+#define _TIMING_H_
+
+#include <stdint.h>
+
+// Below this margin timing_sleep_until_us busy waits instead of sleeping.
+// High resolution waitable timers wake well within it
+#define TIMING_SPIN_MARGIN_US 1000
+// Margin without high resolution timers (before Windows 10 1803), Sleep()
+// can oversleep by a full 15.6ms timer tick
+#define TIMING_SPIN_MARGIN_COARSE_US 16000
+
+// Host monotonic time in microseconds (QueryPerformanceCounter based)
+uint64_t timing_now_us(void);
+
+// Blocks calling thread until host time reaches deadline_us
+void timing_sleep_until_us(uint64_t deadline_us);
+
+#endif
@@ -0,0 +1,383 @@
+#include "txq.h"
+#include "timing.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct txq_entry_t {
+  uint64_t key;
+  uint64_t seq;
+  uint64_t deadline_us;
+  uint8_t cls;
+  void* tag;
+  candle_frame_t frame;
+} txq_entry_t;
+
+struct txq_t {
+  // Binary min-heap on (key, seq)
+  txq_entry_t* heap;
+  size_t count;
+  size_t capacity;
+  uint64_t next_seq;
+
+  uint32_t depths[TXQ_MAX_CLASSES];
+  uint32_t levels[TXQ_MAX_CLASSES];
+  size_t class_count;
+
+  // Send time of frames in device slots, 0 if slot is free
+  uint64_t slot_time_us[TXQ_MAX_SLOTS];
+  void* slot_tag[TXQ_MAX_SLOTS];
+  // Bumped whenever a slot is freed, part of its echo id
+  uint16_t slot_gen[TXQ_MAX_SLOTS];
+  uint8_t slot_count;
+  uint8_t in_flight;
+  uint32_t echo_base;
+
+  SRWLOCK lock;
+  // Signalled when a frame is queued or a slot frees up
+  CONDITION_VARIABLE wake;
+
+  HANDLE thread;
+  volatile bool stop_req;
+
+  txq_send_t send;
+  txq_complete_t complete;
+  void* ctx;
+
+  txq_stats_t stats;
+};
+
+static void txq_complete(txq_t* txq, void* tag, txq_status_t status, uint32_t timestamp_us)
+{
+  if (tag)
+    txq->complete(txq->ctx, tag, status, timestamp_us);
+}
+
+static void txq_free_slot(txq_t* txq, uint8_t slot, txq_status_t status, uint32_t timestamp_us)
+{
+  txq_complete(txq, txq->slot_tag[slot], status, timestamp_us);
+  txq->slot_time_us[slot] = 0;
+  txq->slot_tag[slot] = NULL;
+  txq->slot_gen[slot] = (uint16_t)((txq->slot_gen[slot] + 1) % TXQ_ECHO_GENERATIONS);
+  txq->in_flight--;
+}
+
+static uint32_t txq_echo_id(txq_t* txq, uint8_t slot)
+{
+  return txq->echo_base + (uint32_t)txq->slot_gen[slot]*TXQ_MAX_SLOTS + slot;
+}
+
+uint64_t txq_arbitration_key(uint32_t can_id)
+{
+  bool rtr = (can_id & CANDLE_ID_RTR) != 0;
+
+  // Standard: base id, RTR, IDE (dominant)
+  if (!(can_id & CANDLE_ID_EXTENDED))
+    return ((uint64_t)(can_id & 0x7FF) << 21) | ((uint64_t)rtr << 20);
+
+  // Extended: base id, SRR and IDE (recessive), id extension, RTR
+  uint32_t id = can_id & 0x1FFFFFFF;
+  return ((uint64_t)(id >> 18) << 21) | (1ull << 20) | (1ull << 19) | ((uint64_t)(id & 0x3FFFF) << 1) | rtr;
+}
+
+static bool txq_less(const txq_entry_t* a, const txq_entry_t* b)
+{
+  return a->key < b->key || (a->key == b->key && a->seq < b->seq);
+}
+
+static void txq_swap(txq_entry_t* a, txq_entry_t* b)
+{
+  txq_entry_t tmp = *a;
+  *a = *b;
+  *b = tmp;
+}
+
+static void txq_heap_push(txq_t* txq, const txq_entry_t* entry)
+{
+  size_t i = txq->count++;
+  txq->heap[i] = *entry;
+
+  while (i && txq_less(&txq->heap[i], &txq->heap[(i - 1) / 2])) {
+    txq_swap(&txq->heap[i], &txq->heap[(i - 1) / 2]);
+    i = (i - 1) / 2;
+  }
+}
+
+static void txq_sift_down(txq_t* txq, size_t i)
+{
+  for (;;) {
+    size_t smallest = i;
+    size_t left = 2*i + 1;
+    size_t right = left + 1;
+
+    if (left < txq->count && txq_less(&txq->heap[left], &txq->heap[smallest]))
+      smallest = left;
+    if (right < txq->count && txq_less(&txq->heap[right], &txq->heap[smallest]))
+      smallest = right;
+    if (smallest == i)
+      break;
+
+    txq_swap(&txq->heap[i], &txq->heap[smallest]);
+    i = smallest;
+  }
+}
+
+static void txq_heap_pop(txq_t* txq, txq_entry_t* entry)
+{
+  *entry = txq->heap[0];
+  txq->heap[0] = txq->heap[--txq->count];
+  txq_sift_down(txq, 0);
+}
+
+// Drops frames past their deadline from anywhere in the heap, returns false
+// if there were none
+static bool txq_expire(txq_t* txq, uint64_t now)
+{
+  size_t count = 0;
+
+  for (size_t i = 0; i < txq->count; ++i) {
+    txq_entry_t* entry = &txq->heap[i];
+
+    if (entry->deadline_us && now > entry->deadline_us) {
+      txq_complete(txq, entry->tag, TXQ_STALE, 0);
+      txq->levels[entry->cls]--;
+      txq->stats.stale++;
+    } else {
+      txq->heap[count++] = *entry;
+    }
+  }
+
+  if (count == txq->count)
+    return false;
+
+  txq->count = count;
+  for (size_t i = count / 2; i-- > 0;)
+    txq_sift_down(txq, i);
+
+  return true;
+}
+
+// Frees slots whose echo never came, e.g. frames lost on bus off
+static void txq_reclaim_slots(txq_t* txq, uint64_t now)
+{
+  for (uint8_t i = 0; i < txq->slot_count; ++i) {
+    if (txq->slot_time_us[i] && now - txq->slot_time_us[i] > TXQ_ECHO_TIMEOUT_US) {
+      txq_free_slot(txq, i, TXQ_ECHO_TIMEOUT, 0);
+      txq->stats.echo_timeouts++;
+    }
+  }
+}
+
+static DWORD WINAPI txq_thread(LPVOID lpParam)
+{
+  txq_t* txq = (txq_t*)lpParam;
+  txq_entry_t entry;
+
+  AcquireSRWLockExclusive(&txq->lock);
+
+  while (!txq->stop_req) {
+    txq_reclaim_slots(txq, timing_now_us());
+
+    if (!txq->count || txq->in_flight >= txq->slot_count) {
+      SleepConditionVariableSRW(&txq->wake, &txq->lock, TXQ_POLL_INTERVAL, 0);
+      continue;
+    }
+
+    // Highest priority frame is only taken once a slot is free, so frames
+    // queued meanwhile can still overtake it
+    txq_heap_pop(txq, &entry);
+    txq->levels[entry.cls]--;
+
+    uint64_t now = timing_now_us();
+    if (entry.deadline_us && now > entry.deadline_us) {
+      txq_complete(txq, entry.tag, TXQ_STALE, 0);
+      txq->stats.stale++;
+      continue;
+    }
+
+    uint8_t slot = 0;
+    while (txq->slot_time_us[slot])
+      ++slot;
+
+    txq->slot_time_us[slot] = now;
+    txq->slot_tag[slot] = entry.tag;
+    txq->in_flight++;
+
+    uint32_t echo_id = txq_echo_id(txq, slot);
+
+    ReleaseSRWLockExclusive(&txq->lock);
+    bool res = txq->send(txq->ctx, &entry.frame, echo_id);
+    AcquireSRWLockExclusive(&txq->lock);
+
+    if (res) {
+      txq->stats.sent++;
+    } else {
+      txq->stats.send_errors++;
+      if (txq->slot_time_us[slot] && txq_echo_id(txq, slot) == echo_id)
+        txq_free_slot(txq, slot, TXQ_SEND_ERROR, 0);
+    }
+  }
+
+  ReleaseSRWLockExclusive(&txq->lock);
+
+  return 0;
+}
+
+txq_t* txq_create(const uint32_t* depths, size_t class_count, uint8_t slot_count, uint32_t echo_base,
+  txq_send_t send, txq_complete_t complete, void* ctx)
+{
+  if (!class_count || class_count > TXQ_MAX_CLASSES || !slot_count || slot_count > TXQ_MAX_SLOTS)
+    return NULL;
+
+  txq_t* txq = calloc(1, sizeof(txq_t));
+  if (!txq)
+    return NULL;
+
+  for (size_t i = 0; i < class_count; ++i) {
+    txq->depths[i] = depths[i];
+    txq->capacity += depths[i];
+  }
+
+  txq->class_count = class_count;
+  txq->slot_count = slot_count;
+  txq->echo_base = echo_base;
+  txq->send = send;
+  txq->complete = complete;
+  txq->ctx = ctx;
+  txq->heap = malloc((txq->capacity ? txq->capacity : 1)*sizeof(txq_entry_t));
+
+  InitializeSRWLock(&txq->lock);
+  InitializeConditionVariable(&txq->wake);
+
+  DWORD id;
+  if (txq->heap)
+    txq->thread = CreateThread(NULL, 0, txq_thread, (PVOID)txq, 0, &id);
+
+  if (!txq->thread) {
+    txq_delete(txq);
+    return NULL;
+  }
+
+  return txq;
+}
+
+void txq_delete(txq_t* txq)
+{
+  if (!txq)
+    return;
+
+  if (txq->thread) {
+    AcquireSRWLockExclusive(&txq->lock);
+    txq->stop_req = true;
+    ReleaseSRWLockExclusive(&txq->lock);
+    WakeAllConditionVariable(&txq->wake);
+
+    WaitForSingleObject(txq->thread, INFINITE);
+    CloseHandle(txq->thread);
+  }
+
+  // Thread is gone, nothing else uses the queue
+  for (size_t i = 0; i < txq->count; ++i)
+    txq_complete(txq, txq->heap[i].tag, TXQ_CANCELLED, 0);
+
+  for (uint8_t i = 0; i < txq->slot_count; ++i) {
+    if (txq->slot_time_us[i])
+      txq_free_slot(txq, i, TXQ_CANCELLED, 0);
+  }
+
+  free(txq->heap);
+  free(txq);
+}
+
+bool txq_push(txq_t* txq, const candle_frame_t* frame, uint8_t cls, uint64_t deadline_us, void* tag)
+{
+  bool res = false;
+
+  if (cls >= txq->class_count)
+    return false;
+
+  AcquireSRWLockExclusive(&txq->lock);
+
+  // Expired frames would otherwise hold their class depth until popped
+  if (txq->levels[cls] >= txq->depths[cls])
+    txq_expire(txq, timing_now_us());
+
+  if (txq->levels[cls] < txq->depths[cls]) {
+    txq_entry_t entry;
+    entry.key = txq_arbitration_key(frame->can_id);
+    entry.seq = txq->next_seq++;
+    entry.deadline_us = deadline_us;
+    entry.cls = cls;
+    entry.tag = tag;
+    entry.frame = *frame;
+
+    txq_heap_push(txq, &entry);
+    txq->levels[cls]++;
+    txq->stats.queued++;
+    res = true;
+  } else {
+    txq->stats.rejected++;
+  }
+
+  ReleaseSRWLockExclusive(&txq->lock);
+
+  if (res)
+    WakeConditionVariable(&txq->wake);
+
+  return res;
+}
+
+void txq_echo(txq_t* txq, uint32_t echo_id, uint32_t timestamp_us)
+{
+  uint32_t offset = echo_id - txq->echo_base;
+  uint32_t slot = offset % TXQ_MAX_SLOTS;
+
+  if (offset >= TXQ_ECHO_GENERATIONS*TXQ_MAX_SLOTS || slot >= txq->slot_count)
+    return;
+
+  AcquireSRWLockExclusive(&txq->lock);
+
+  // Echo of an earlier frame in a reclaimed slot is ignored
+  bool freed = txq->slot_time_us[slot] != 0 && txq_echo_id(txq, (uint8_t)slot) == echo_id;
+  if (freed)
+    txq_free_slot(txq, (uint8_t)slot, TXQ_SENT, timestamp_us);
+
+  ReleaseSRWLockExclusive(&txq->lock);
+
+  if (freed)
+    WakeConditionVariable(&txq->wake);
+}
+
+size_t txq_levels(txq_t* txq, uint32_t* levels, size_t class_count)
+{
+  AcquireSRWLockShared(&txq->lock);
+
+  size_t count = txq->count;
+  for (size_t i = 0; i < class_count && i < txq->class_count; ++i)
+    levels[i] = txq->levels[i];
+
+  ReleaseSRWLockShared(&txq->lock);
+
+  return count;
+}
+
+size_t txq_class_count(txq_t* txq)
+{
+  return txq->class_count;
+}
+
+size_t txq_in_flight(txq_t* txq)
+{
+  return txq->in_flight;
+}
+
+void txq_stats(txq_t* txq, txq_stats_t* stats, bool reset)
+{
+  AcquireSRWLockExclusive(&txq->lock);
+
+  *stats = txq->stats;
+  if (reset)
+    memset(&txq->stats, 0, sizeof(txq->stats));
+
+  ReleaseSRWLockExclusive(&txq->lock);
+}
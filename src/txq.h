@@ -0,0 +1,80 @@
+#ifndef _TXQ_H_
+#define _TXQ_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "candle_api/candle.h"
+
+#define TXQ_MAX_CLASSES 8
+// Frames on their way to the bus at once, each needs a device TX slot
+#define TXQ_MAX_SLOTS 32
+// Slot whose echo does not arrive within this time is reused
+#define TXQ_ECHO_TIMEOUT_US 1000000
+// Reuses of a slot told apart by its echo id, so a late echo of a reclaimed
+// slot does not complete the frame sent next in it
+#define TXQ_ECHO_GENERATIONS 65536
+// Interval at which the TX thread checks for stop and lost echoes
+#define TXQ_POLL_INTERVAL 100 // in ms
+
+typedef enum {
+  // Echo arrived, timestamp is valid
+  TXQ_SENT,
+  TXQ_SEND_ERROR,
+  TXQ_STALE,
+  TXQ_ECHO_TIMEOUT,
+  // Queue was deleted first
+  TXQ_CANCELLED,
+} txq_status_t;
+
+// Sends frame with given echo id, called on the TX thread
+typedef bool (*txq_send_t)(void* ctx, candle_frame_t* frame, uint32_t echo_id);
+// Reports outcome of a frame queued with a tag, called with the queue lock
+// held on the TX thread, the RX thread or in txq_delete
+typedef void (*txq_complete_t)(void* ctx, void* tag, txq_status_t status, uint32_t timestamp_us);
+
+typedef struct txq_stats_t {
+  uint64_t queued;
+  uint64_t sent;
+  uint64_t send_errors;
+  // Rejected because the class was full
+  uint64_t rejected;
+  // Dropped because their deadline passed before a slot was free
+  uint64_t stale;
+  uint64_t echo_timeouts;
+} txq_stats_t;
+
+// Transmit queue ordered by CAN arbitration priority, like the bus would
+// order the same frames. Frames of equal priority keep their order. A TX
+// thread keeps at most slot_count frames in the device and sees slots free
+// up by their echo ids, echo_base + generation*TXQ_MAX_SLOTS + slot, which
+// stay below echo_base + TXQ_ECHO_GENERATIONS*TXQ_MAX_SLOTS.
+typedef struct txq_t txq_t;
+
+// Depths limit queued frames per class, class_count of them
+txq_t* txq_create(const uint32_t* depths, size_t class_count, uint8_t slot_count, uint32_t echo_base,
+  txq_send_t send, txq_complete_t complete, void* ctx);
+// Frames still queued or waiting for echo are completed as cancelled
+void txq_delete(txq_t* txq);
+
+// Returns false if class is full. Deadline is host time in us, 0 is none.
+// Frames past their deadline are dropped here too before a full class
+// rejects the frame. Outcome of frames with a non-NULL tag is reported to the
+// complete callback
+bool txq_push(txq_t* txq, const candle_frame_t* frame, uint8_t cls, uint64_t deadline_us, void* tag);
+
+// Frees slot of echoed frame, called by the RX thread for every echo
+void txq_echo(txq_t* txq, uint32_t echo_id, uint32_t timestamp_us);
+
+// Level of each class, returns total level
+size_t txq_levels(txq_t* txq, uint32_t* levels, size_t class_count);
+size_t txq_class_count(txq_t* txq);
+size_t txq_in_flight(txq_t* txq);
+// Copies counters and optionally resets them
+void txq_stats(txq_t* txq, txq_stats_t* stats, bool reset);
+
+// Priority key, lower wins arbitration. Bit order is the order of the
+// arbitration field on the wire
+uint64_t txq_arbitration_key(uint32_t can_id);
+
+#endif
@@ -0,0 +1,302 @@
+#include "uavcan.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Tail byte layout
+#define UAVCAN_TAIL_SOT 0x80
+#define UAVCAN_TAIL_EOT 0x40
+#define UAVCAN_TAIL_TOGGLE 0x20
+#define UAVCAN_TAIL_TID_MASK 0x1F
+
+uavcan_t* uavcan_create(void)
+{
+  uavcan_t* uavcan = calloc(1, sizeof(uavcan_t));
+  if (!uavcan)
+    return NULL;
+
+  uavcan->rx_fifo = fifo_create(sizeof(uavcan_transfer_t), UAVCAN_RX_QUEUE_SIZE);
+
+  return uavcan;
+}
+
+void uavcan_delete(uavcan_t* uavcan)
+{
+  if (!uavcan)
+    return;
+
+  fifo_delete(uavcan->rx_fifo);
+  free(uavcan);
+}
+
+bool uavcan_register(uavcan_t* uavcan, uint16_t data_type_id, bool service, uint64_t signature)
+{
+  uavcan_data_type_t* type = uavcan_find_data_type(uavcan, data_type_id, service);
+
+  if (type) {
+    type->signature = signature;
+    return true;
+  }
+
+  if (uavcan->data_type_count >= UAVCAN_MAX_DATA_TYPES)
+    return false;
+
+  type = &uavcan->data_types[uavcan->data_type_count];
+  type->id = data_type_id;
+  type->service = service;
+  type->signature = signature;
+
+  // Entry must be complete before RX thread can see it
+  MemoryBarrier();
+  uavcan->data_type_count++;
+
+  return true;
+}
+
+uavcan_data_type_t* uavcan_find_data_type(uavcan_t* uavcan, uint16_t data_type_id, bool service)
+{
+  for (uint8_t i = 0; i < uavcan->data_type_count; ++i) {
+    uavcan_data_type_t* type = &uavcan->data_types[i];
+    if (type->id == data_type_id && type->service == service)
+      return type;
+  }
+
+  return NULL;
+}
+
+// CRC-16-CCITT (poly 0x1021, initial value 0xFFFF)
+uint16_t uavcan_crc_add(uint16_t crc, const uint8_t* data, size_t len)
+{
+  while (len--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t i = 0; i < 8; ++i)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+
+  return crc;
+}
+
+// Transfer CRC covers data type signature followed by the payload
+static uint16_t uavcan_crc_signature(uint64_t signature)
+{
+  uint8_t buf[8];
+
+  for (uint8_t i = 0; i < 8; ++i)
+    buf[i] = (uint8_t)(signature >> (8*i));
+
+  return uavcan_crc_add(0xFFFF, buf, sizeof(buf));
+}
+
+// Parses CAN id into transfer header
+static void uavcan_parse_id(uint32_t can_id, uavcan_transfer_t* transfer)
+{
+  transfer->priority = (can_id >> 24) & 0x1F;
+  transfer->source_node = can_id & 0x7F;
+
+  if (can_id & (1 << 7)) {
+    transfer->kind = (can_id & (1 << 15)) ? UAVCAN_TRANSFER_REQUEST : UAVCAN_TRANSFER_RESPONSE;
+    transfer->data_type_id = (can_id >> 16) & 0xFF;
+    transfer->destination_node = (can_id >> 8) & 0x7F;
+  } else {
+    transfer->kind = UAVCAN_TRANSFER_MESSAGE;
+    transfer->data_type_id = (can_id >> 8) & 0xFFFF;
+    transfer->destination_node = 0;
+
+    // Anonymous messages only carry 2 lower bits of data type id
+    if (!transfer->source_node)
+      transfer->data_type_id &= 0x3;
+  }
+}
+
+static uint32_t uavcan_make_id(const uavcan_transfer_t* transfer)
+{
+  uint32_t can_id = CANDLE_ID_EXTENDED | ((uint32_t)(transfer->priority & 0x1F) << 24) | (transfer->source_node & 0x7F);
+
+  if (transfer->kind == UAVCAN_TRANSFER_MESSAGE) {
+    can_id |= (uint32_t)transfer->data_type_id << 8;
+  } else {
+    can_id |= ((uint32_t)(transfer->data_type_id & 0xFF) << 16) | ((transfer->destination_node & 0x7F) << 8) | (1 << 7);
+    if (transfer->kind == UAVCAN_TRANSFER_REQUEST)
+      can_id |= 1 << 15;
+  }
+
+  return can_id;
+}
+
+static bool uavcan_session_match(uavcan_session_t* session, uavcan_transfer_t* header)
+{
+  uavcan_transfer_t* t = &session->transfer;
+
+  return t->source_node == header->source_node &&
+    t->destination_node == header->destination_node &&
+    t->data_type_id == header->data_type_id &&
+    t->kind == header->kind &&
+    t->transfer_id == header->transfer_id;
+}
+
+// Finds session for transfer. Start of transfer may also take a free or expired slot
+static uavcan_session_t* uavcan_find_session(uavcan_t* uavcan, uavcan_transfer_t* header, uint32_t timestamp_us, bool start)
+{
+  uavcan_session_t* free_session = NULL;
+
+  for (size_t i = 0; i < UAVCAN_MAX_SESSIONS; ++i) {
+    uavcan_session_t* session = &uavcan->sessions[i];
+
+    if (session->active && timestamp_us - session->last_timestamp_us > UAVCAN_TRANSFER_TIMEOUT_US)
+      session->active = false;
+
+    if (!session->active) {
+      if (!free_session)
+        free_session = session;
+      continue;
+    }
+
+    if (uavcan_session_match(session, header))
+      return session;
+  }
+
+  return start ? free_session : NULL;
+}
+
+bool uavcan_on_frame(uavcan_t* uavcan, candle_frame_t* frame)
+{
+  uavcan_transfer_t header;
+
+  // UAVCAN uses only extended data frames with tail byte
+  // UAVCAN v0 is defined for classic CAN only
+  if (!candle_frame_is_extended_id(frame) || candle_frame_is_rtr(frame) || candle_frame_is_fd(frame) || !frame->can_dlc)
+    return false;
+
+  uavcan_parse_id(frame->can_id, &header);
+
+  uavcan_data_type_t* type = uavcan_find_data_type(uavcan, header.data_type_id, header.kind != UAVCAN_TRANSFER_MESSAGE);
+  if (!type)
+    return false;
+
+  uint8_t tail = frame->data[frame->can_dlc - 1];
+  uint8_t len = frame->can_dlc - 1;
+  bool toggle = (tail & UAVCAN_TAIL_TOGGLE) != 0;
+  header.transfer_id = tail & UAVCAN_TAIL_TID_MASK;
+  header.timestamp_us = frame->timestamp_us;
+
+  // Single frame transfer
+  if ((tail & UAVCAN_TAIL_SOT) && (tail & UAVCAN_TAIL_EOT)) {
+    header.size = len;
+    memcpy(header.payload, frame->data, len);
+    fifo_add_force(uavcan->rx_fifo, &header);
+    return true;
+  }
+
+  uavcan_session_t* session = uavcan_find_session(uavcan, &header, frame->timestamp_us, (tail & UAVCAN_TAIL_SOT) != 0);
+  if (!session)
+    return true;
+
+  if (tail & UAVCAN_TAIL_SOT) {
+    // First frame starts with transfer CRC and must have toggle cleared
+    if (toggle || len < 2)
+      return true;
+
+    session->transfer = header;
+    session->transfer.size = 0;
+    session->crc = frame->data[0] | (frame->data[1] << 8);
+    session->toggle = false;
+    session->active = true;
+
+    memcpy(session->transfer.payload, frame->data + 2, len - 2);
+    session->transfer.size = len - 2;
+  } else {
+    // Toggle mismatch means duplicated or lost frame
+    if (toggle == session->toggle)
+      return true;
+
+    if (session->transfer.size + len > UAVCAN_MAX_TRANSFER_SIZE) {
+      session->active = false;
+      return true;
+    }
+
+    memcpy(session->transfer.payload + session->transfer.size, frame->data, len);
+    session->transfer.size += len;
+    session->toggle = toggle;
+  }
+
+  session->last_timestamp_us = frame->timestamp_us;
+
+  if (tail & UAVCAN_TAIL_EOT) {
+    session->active = false;
+
+    uint16_t crc = uavcan_crc_add(uavcan_crc_signature(type->signature), session->transfer.payload, session->transfer.size);
+    if (crc == session->crc)
+      fifo_add_force(uavcan->rx_fifo, &session->transfer);
+  }
+
+  return true;
+}
+
+static bool uavcan_send_frame(candle_channel_stats_t* stats, candle_handle handle, uint8_t ch, candle_frame_t* frame)
+{
+  bool res = candle_frame_send(handle, ch, frame);
+  if (stats)
+    stats_count_tx(stats, frame->can_dlc, res);
+
+  return res;
+}
+
+bool uavcan_send(uavcan_t* uavcan, candle_handle handle, uint8_t ch, candle_channel_stats_t* stats, const uavcan_transfer_t* transfer)
+{
+  candle_frame_t frame;
+  uint32_t can_id = uavcan_make_id(transfer);
+  uint8_t tid = transfer->transfer_id & UAVCAN_TAIL_TID_MASK;
+
+  // Single frame transfer
+  if (transfer->size <= 7) {
+    frame.can_id = can_id;
+    frame.flags = 0;
+    memcpy(frame.data, transfer->payload, transfer->size);
+    frame.data[transfer->size] = UAVCAN_TAIL_SOT | UAVCAN_TAIL_EOT | tid;
+    frame.can_dlc = (uint8_t)transfer->size + 1;
+    return uavcan_send_frame(stats, handle, ch, &frame);
+  }
+
+  // Multi-frame transfers need the signature of a registered data type
+  if (!uavcan)
+    return false;
+
+  uavcan_data_type_t* type = uavcan_find_data_type(uavcan, transfer->data_type_id, transfer->kind != UAVCAN_TRANSFER_MESSAGE);
+  if (!type)
+    return false;
+
+  uint16_t crc = uavcan_crc_add(uavcan_crc_signature(type->signature), transfer->payload, transfer->size);
+  size_t offset = 0;
+  bool toggle = false;
+
+  while (offset < transfer->size) {
+    uint8_t len = 0;
+    bool first = !offset;
+
+    frame.can_id = can_id;
+    frame.flags = 0;
+
+    // First frame carries transfer CRC
+    if (first) {
+      frame.data[len++] = (uint8_t)crc;
+      frame.data[len++] = (uint8_t)(crc >> 8);
+    }
+
+    while (len < 7 && offset < transfer->size)
+      frame.data[len++] = transfer->payload[offset++];
+
+    frame.data[len] = tid | (toggle ? UAVCAN_TAIL_TOGGLE : 0);
+    if (first)
+      frame.data[len] |= UAVCAN_TAIL_SOT;
+    if (offset >= transfer->size)
+      frame.data[len] |= UAVCAN_TAIL_EOT;
+
+    frame.can_dlc = len + 1;
+
+    if (!uavcan_send_frame(stats, handle, ch, &frame))
+      return false;
+
+    toggle = !toggle;
+  }
+
+  return true;
+}
@@ -0,0 +1,78 @@
+#ifndef _UAVCAN_H_
+#define _UAVCAN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "candle_api/candle.h"
+#include "fifo.h"
+#include "stats.h"
+
+#define UAVCAN_MAX_TRANSFER_SIZE 1024
+#define UAVCAN_MAX_DATA_TYPES 64
+#define UAVCAN_MAX_SESSIONS 32
+#define UAVCAN_RX_QUEUE_SIZE 16
+#define UAVCAN_TRANSFER_TIMEOUT_US 2000000
+
+typedef enum {
+  UAVCAN_TRANSFER_MESSAGE,
+  UAVCAN_TRANSFER_REQUEST,
+  UAVCAN_TRANSFER_RESPONSE,
+} uavcan_transfer_kind_t;
+
+typedef struct uavcan_transfer_t {
+  // Timestamp of the first frame
+  uint32_t timestamp_us;
+  uint16_t data_type_id;
+  uint8_t kind;
+  uint8_t priority;
+  uint8_t source_node;
+  // 0 for broadcast messages
+  uint8_t destination_node;
+  uint8_t transfer_id;
+
+  uint16_t size;
+  uint8_t payload[UAVCAN_MAX_TRANSFER_SIZE];
+} uavcan_transfer_t;
+
+typedef struct uavcan_data_type_t {
+  uint16_t id;
+  bool service;
+  uint64_t signature;
+} uavcan_data_type_t;
+
+// Multi-frame transfer being reassembled
+typedef struct uavcan_session_t {
+  bool active;
+  bool toggle;
+  uint16_t crc;
+  uint32_t last_timestamp_us;
+  uavcan_transfer_t transfer;
+} uavcan_session_t;
+
+typedef struct uavcan_t {
+  // Only frames of registered data types are processed
+  uavcan_data_type_t data_types[UAVCAN_MAX_DATA_TYPES];
+  volatile uint8_t data_type_count;
+
+  uavcan_session_t sessions[UAVCAN_MAX_SESSIONS];
+
+  // Complete transfers
+  fifo_t* rx_fifo;
+} uavcan_t;
+
+uavcan_t* uavcan_create(void);
+void uavcan_delete(uavcan_t* uavcan);
+
+bool uavcan_register(uavcan_t* uavcan, uint16_t data_type_id, bool service, uint64_t signature);
+uavcan_data_type_t* uavcan_find_data_type(uavcan_t* uavcan, uint16_t data_type_id, bool service);
+
+// Called by the RX thread, returns false if frame is not UAVCAN frame of registered data type
+bool uavcan_on_frame(uavcan_t* uavcan, candle_frame_t* frame);
+
+// Splits transfer into frames and sends them. Uavcan may be NULL for single
+// frame transfers, stats (optional) count transmitted frames
+bool uavcan_send(uavcan_t* uavcan, candle_handle handle, uint8_t ch, candle_channel_stats_t* stats, const uavcan_transfer_t* transfer);
+
+uint16_t uavcan_crc_add(uint16_t crc, const uint8_t* data, size_t len);
+
+#endif